@@ -0,0 +1,24 @@
+#include "irc_any_message.hpp"
+
+#include "irc_message.hpp"
+#include "irc_numeric_message.hpp"
+#include "irc_standard_message.hpp"
+
+#include <iostream>
+#include <variant>
+
+vassal::irc::message::type vassal::irc::get_type(const any_message &m) {
+  return static_cast<message::type>(m.index());
+}
+
+const vassal::irc::message &vassal::irc::as_message(const any_message &m) {
+  return std::visit(
+      [](const auto &alternative) -> const message & { return alternative; },
+      m);
+}
+
+std::ostream &vassal::irc::operator<<(std::ostream &out,
+                                      const any_message &m) {
+  out << as_message(m);
+  return out;
+}
@@ -0,0 +1,38 @@
+#ifndef VASSAL_IRC_ANY_MESSAGE_HPP
+#define VASSAL_IRC_ANY_MESSAGE_HPP
+
+#include "irc_message.hpp"
+#include "irc_numeric_message.hpp"
+#include "irc_standard_message.hpp"
+
+#include <cstddef>
+#include <iostream>
+#include <type_traits>
+#include <variant>
+
+namespace vassal {
+
+namespace irc {
+// Owned message held by value. The alternatives are ordered like
+// message::type, so the active index doubles as the message type.
+using any_message = std::variant<standard_message, numeric_message>;
+
+static_assert(std::is_same_v<std::variant_alternative_t<
+                                 static_cast<std::size_t>(
+                                     message::type::standard),
+                                 any_message>,
+                             standard_message>);
+static_assert(std::is_same_v<std::variant_alternative_t<
+                                 static_cast<std::size_t>(
+                                     message::type::numeric),
+                                 any_message>,
+                             numeric_message>);
+
+message::type get_type(const any_message &m);
+const message &as_message(const any_message &m);
+
+std::ostream &operator<<(std::ostream &out, const any_message &m);
+} // namespace irc
+
+} // namespace vassal
+#endif
@@ -0,0 +1,246 @@
+#ifndef VASSAL_IRC_COMMANDS_HPP
+#define VASSAL_IRC_COMMANDS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace vassal {
+
+namespace irc {
+enum class command : std::uint8_t {
+  unknown = 0,
+  pass,
+  nick,
+  user,
+  oper,
+  mode,
+  service,
+  quit,
+  squit,
+  join,
+  part,
+  topic,
+  names,
+  list,
+  invite,
+  kick,
+  privmsg,
+  notice,
+  motd,
+  lusers,
+  version,
+  stats,
+  links,
+  time,
+  connect,
+  trace,
+  admin,
+  info,
+  servlist,
+  squery,
+  who,
+  whois,
+  whowas,
+  kill,
+  ping,
+  pong,
+  error,
+  away,
+  rehash,
+  die,
+  restart,
+  summon,
+  users,
+  wallops,
+  userhost,
+  ison,
+  cap,
+  authenticate,
+  account,
+  batch,
+  chghost,
+  setname,
+  tagmsg,
+  N,
+};
+
+namespace commands {
+inline constexpr std::array<std::string_view,
+                             static_cast<std::size_t>(command::N)>
+    k_command_names{
+        "",
+        "PASS",
+        "NICK",
+        "USER",
+        "OPER",
+        "MODE",
+        "SERVICE",
+        "QUIT",
+        "SQUIT",
+        "JOIN",
+        "PART",
+        "TOPIC",
+        "NAMES",
+        "LIST",
+        "INVITE",
+        "KICK",
+        "PRIVMSG",
+        "NOTICE",
+        "MOTD",
+        "LUSERS",
+        "VERSION",
+        "STATS",
+        "LINKS",
+        "TIME",
+        "CONNECT",
+        "TRACE",
+        "ADMIN",
+        "INFO",
+        "SERVLIST",
+        "SQUERY",
+        "WHO",
+        "WHOIS",
+        "WHOWAS",
+        "KILL",
+        "PING",
+        "PONG",
+        "ERROR",
+        "AWAY",
+        "REHASH",
+        "DIE",
+        "RESTART",
+        "SUMMON",
+        "USERS",
+        "WALLOPS",
+        "USERHOST",
+        "ISON",
+        "CAP",
+        "AUTHENTICATE",
+        "ACCOUNT",
+        "BATCH",
+        "CHGHOST",
+        "SETNAME",
+        "TAGMSG",
+    };
+
+inline constexpr std::size_t k_hash_table_size{256};
+inline constexpr std::uint32_t k_hash_max_seed{1u << 16};
+inline constexpr std::uint32_t k_fnv_offset_basis{2166136261u};
+inline constexpr std::uint32_t k_fnv_prime{16777619u};
+
+constexpr char to_upper(const char c) {
+  return (((c >= 'a') && (c <= 'z')) ? static_cast<char>(c - ('a' - 'A'))
+                                     : c);
+}
+
+constexpr bool equals_ignore_case(const std::string_view lhs,
+                                  const std::string_view rhs) {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+
+  for (std::size_t i{0}; i < lhs.size(); ++i) {
+    if (to_upper(lhs[i]) != to_upper(rhs[i])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+constexpr std::uint32_t hash(const std::string_view name,
+                             const std::uint32_t seed) {
+  std::uint32_t h{k_fnv_offset_basis ^ seed};
+  for (const char c : name) {
+    h ^= static_cast<std::uint8_t>(to_upper(c));
+    h *= k_fnv_prime;
+  }
+
+  return (h ^ (h >> 16));
+}
+
+consteval bool is_perfect(const std::uint32_t seed) {
+  std::array<bool, k_hash_table_size> used{};
+
+  for (std::size_t i{1}; i < k_command_names.size(); ++i) {
+    const std::size_t slot{hash(k_command_names[i], seed) %
+                           k_hash_table_size};
+    if (used[slot] == true) {
+      return false;
+    }
+    used[slot] = true;
+  }
+
+  return true;
+}
+
+consteval std::uint32_t find_seed() {
+  for (std::uint32_t seed{0}; seed < k_hash_max_seed; ++seed) {
+    if (is_perfect(seed) == true) {
+      return seed;
+    }
+  }
+
+  return k_hash_max_seed;
+}
+
+inline constexpr std::uint32_t k_hash_seed{find_seed()};
+
+static_assert(k_hash_seed < k_hash_max_seed,
+              "no collision-free seed found for the command hash table");
+
+consteval std::array<command, k_hash_table_size> make_hash_table() {
+  std::array<command, k_hash_table_size> table{};
+
+  for (std::size_t i{1}; i < k_command_names.size(); ++i) {
+    table[hash(k_command_names[i], k_hash_seed) % k_hash_table_size] =
+        static_cast<command>(i);
+  }
+
+  return table;
+}
+
+inline constexpr std::array<command, k_hash_table_size> k_hash_table{
+    make_hash_table()};
+
+constexpr command lookup(const std::string_view name) {
+  const command candidate{
+      k_hash_table[hash(name, k_hash_seed) % k_hash_table_size]};
+
+  if ((candidate != command::unknown) &&
+      (equals_ignore_case(
+           k_command_names[static_cast<std::size_t>(candidate)], name) ==
+       true)) {
+    return candidate;
+  }
+
+  return command::unknown;
+}
+
+constexpr std::string_view get_name(const command c) {
+  return ((c < command::N) ? k_command_names[static_cast<std::size_t>(c)]
+                           : std::string_view{});
+}
+
+consteval bool check_lookup() {
+  for (std::size_t i{1}; i < k_command_names.size(); ++i) {
+    if (lookup(k_command_names[i]) != static_cast<command>(i)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static_assert(check_lookup() == true,
+              "every command name must map back to its own enumerator");
+static_assert(lookup("privmsg") == command::privmsg);
+static_assert(lookup("FOOBAR") == command::unknown);
+static_assert(lookup("") == command::unknown);
+} // namespace commands
+} // namespace irc
+
+} // namespace vassal
+#endif
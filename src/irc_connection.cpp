@@ -0,0 +1,1373 @@
+#include "irc_connection.hpp"
+
+#include "irc_dispatcher.hpp"
+#include "irc_event_loop.hpp"
+#include "irc_framer.hpp"
+#include "irc_inbound_queue.hpp"
+#include "irc_interest_filter.hpp"
+#include "irc_message_builder.hpp"
+#include "irc_message_slab.hpp"
+#include "irc_message_view.hpp"
+#include "irc_reply_tracker.hpp"
+#include "irc_send_scheduler.hpp"
+
+#include "color_codes.hpp"
+#include "output_mutex.hpp"
+
+#include "liblocket/liblocket.hpp"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+vassal::irc::connection::connection(
+    const std::string &server_address, const uint16_t port_num,
+    const std::string &nick,
+    const liblocket::inet_socket_addr::ip_version ip_version,
+    const inbound_queue::config &queue_config,
+    dispatcher *const message_dispatcher,
+    const send_scheduler::config &send_config)
+    : m_server_address{make_server_address(server_address, port_num,
+                                           ip_version)},
+      m_nick{nick}, m_source_length{make_source_length(nick)},
+      m_max_privmsg_targets{1}, m_max_notice_targets{1},
+      m_is_targmax_known{false},
+      m_socket{liblocket::socket::dummy_type_connect{}, m_server_address},
+      m_send_scheduler{send_config},
+      m_send_deadline{std::chrono::steady_clock::time_point::max()},
+      m_outbound_lines{}, m_outbound_offset{0}, m_spare_lines{},
+      m_outbound_mutex{},
+      m_is_write_requested{false}, m_framer{}, m_message_slab{},
+      m_unread_responses{queue_config}, m_deferred_responses{},
+      m_is_reading_paused{false},
+      m_dispatcher{message_dispatcher}, m_interest_filter{},
+      m_interest_filter_mutex{}, m_filtered_line_count{0}, m_reply_tracker{},
+      m_query_mutex{}, m_waiters{}, m_waiter_deadlines{}, m_waiters_mutex{},
+      m_waiter_count{0}, m_is_closed{false},
+      m_event_loop{nullptr}, m_listener_thread{},
+      m_listener_thread_kill_yourself{false},
+      m_listener_thread_wakeup_fd{::eventfd(0, EFD_CLOEXEC)} {
+  m_spare_lines.reserve(m_k_max_spare_lines);
+
+  if (m_listener_thread_wakeup_fd == -1) {
+    delete m_server_address;
+    throw std::runtime_error{
+        std::string{"failed to create listener wakeup fd ("} +
+        std::strerror(errno) + ")"};
+  }
+
+  // the listener stops reading the socket rather than wait for room in the
+  // inbound queue, so it can keep writing; a consumer wakes it once there is
+  m_unread_responses.set_space_callback(
+      [wakeup_fd{m_listener_thread_wakeup_fd}]() -> void {
+        const std::uint64_t value{1};
+        [[maybe_unused]] const ssize_t written{
+            ::write(wakeup_fd, &value, sizeof(value))};
+      });
+
+  m_listener_thread = std::thread{&irc::connection::listen, this};
+}
+
+vassal::irc::connection::connection(
+    event_loop &loop, const std::string &server_address,
+    const uint16_t port_num, const std::string &nick,
+    const liblocket::inet_socket_addr::ip_version ip_version,
+    const inbound_queue::config &queue_config,
+    dispatcher *const message_dispatcher,
+    const send_scheduler::config &send_config)
+    : m_server_address{make_server_address(server_address, port_num,
+                                           ip_version)},
+      m_nick{nick}, m_source_length{make_source_length(nick)},
+      m_max_privmsg_targets{1}, m_max_notice_targets{1},
+      m_is_targmax_known{false},
+      m_socket{liblocket::socket::dummy_type_connect{}, m_server_address},
+      m_send_scheduler{send_config},
+      m_send_deadline{std::chrono::steady_clock::time_point::max()},
+      m_outbound_lines{}, m_outbound_offset{0}, m_spare_lines{},
+      m_outbound_mutex{},
+      m_is_write_requested{false}, m_framer{}, m_message_slab{},
+      m_unread_responses{queue_config}, m_deferred_responses{},
+      m_is_reading_paused{false},
+      m_dispatcher{message_dispatcher}, m_interest_filter{},
+      m_interest_filter_mutex{}, m_filtered_line_count{0}, m_reply_tracker{},
+      m_query_mutex{}, m_waiters{}, m_waiter_deadlines{}, m_waiters_mutex{},
+      m_waiter_count{0}, m_is_closed{false},
+      m_event_loop{&loop}, m_listener_thread{},
+      m_listener_thread_kill_yourself{false},
+      m_listener_thread_wakeup_fd{-1} {
+  m_spare_lines.reserve(m_k_max_spare_lines);
+
+  // the loop thread never waits for room in the inbound queue; it stops
+  // reading this socket instead until a consumer has made some
+  m_unread_responses.set_space_callback(
+      [&loop, fd{m_socket.get_fd()}]() -> void { loop.resume_reading(fd); });
+
+  m_event_loop->add(m_socket.get_fd(), this);
+}
+
+vassal::irc::connection::~connection() {
+  m_listener_thread_kill_yourself = true;
+
+  // lines already handed to io_uring get a short while to go out first
+  const std::chrono::steady_clock::time_point final_write_deadline{
+      std::chrono::steady_clock::now() + m_k_final_write_timeout};
+  bool is_socket_idle{true};
+
+  if (m_event_loop != nullptr) {
+    is_socket_idle =
+        m_event_loop->remove(m_socket.get_fd(), final_write_deadline);
+    m_event_loop = nullptr;
+  }
+
+  wake_listener();
+
+  if (m_listener_thread.joinable() == true) {
+    m_listener_thread.join();
+  }
+
+  // closed only once nothing handles input any more, so the line being
+  // handled (a PING, say) never finds the connection half shut down
+  m_unread_responses.close();
+
+  if (m_listener_thread_wakeup_fd != -1) {
+    ::close(m_listener_thread_wakeup_fd);
+    m_listener_thread_wakeup_fd = -1;
+  }
+
+  // the urgent lane (a QUIT, usually) goes out before the socket closes, as
+  // far as the socket takes it in time; writing while the ring still has
+  // sends in flight would interleave with them
+  if (is_socket_idle == true) {
+    write_final(final_write_deadline);
+  }
+
+  // resumed only once nothing else can resume them
+  m_reply_tracker.close();
+  close_waiters();
+
+  delete m_server_address;
+  m_server_address = nullptr;
+}
+
+vassal::irc::message_view vassal::irc::connection::recv_response_view() {
+  message_view response{};
+
+  if (m_unread_responses.pop(response) == false) {
+    throw std::runtime_error{"connection is shutting down"};
+  }
+
+  return response;
+}
+
+std::size_t vassal::irc::connection::recv_responses(
+    const std::span<message_view> responses,
+    const std::chrono::milliseconds timeout) {
+  const std::chrono::steady_clock::time_point deadline{
+      (timeout == std::chrono::milliseconds::max())
+          ? std::chrono::steady_clock::time_point::max()
+          : (std::chrono::steady_clock::now() + timeout)};
+
+  const std::size_t count{m_unread_responses.pop(responses, deadline)};
+
+  if ((count == 0) && (responses.size() != 0) &&
+      (m_unread_responses.is_closed() == true)) {
+    throw std::runtime_error{"connection is shutting down"};
+  }
+
+  return count;
+}
+
+bool vassal::irc::connection::try_recv_response(message_view &response) {
+  return m_unread_responses.try_pop(response);
+}
+
+vassal::irc::message_slab &vassal::irc::connection::get_message_slab() {
+  return m_message_slab;
+}
+
+vassal::irc::connection::memory_usage
+vassal::irc::connection::get_memory_usage() const {
+  const message_slab::usage message_slab_usage{m_message_slab.get_usage()};
+
+  return memory_usage{m_framer.get_allocated_bytes(),
+                      message_slab_usage.reserved_bytes,
+                      message_slab_usage.slots_in_use};
+}
+
+void vassal::irc::connection::set_interest_filter(
+    const interest_filter &filter) {
+  std::unique_lock<std::mutex> interest_filter_lock{m_interest_filter_mutex};
+  m_interest_filter = filter;
+}
+
+vassal::irc::interest_filter
+vassal::irc::connection::get_interest_filter() const {
+  std::unique_lock<std::mutex> interest_filter_lock{m_interest_filter_mutex};
+  return m_interest_filter;
+}
+
+std::size_t vassal::irc::connection::get_filtered_line_count() const {
+  return m_filtered_line_count.load(std::memory_order_relaxed);
+}
+
+vassal::irc::inbound_queue::counters
+vassal::irc::connection::get_queue_counters() const {
+  return m_unread_responses.get_counters();
+}
+
+void vassal::irc::connection::send_message(const std::string_view message) {
+  send_message(message, send_scheduler::classify(message));
+}
+
+void vassal::irc::connection::send_message(
+    const std::string_view message, const send_scheduler::priority lane) {
+  if (message.size() > m_k_max_message_length) {
+    throw std::runtime_error{"message is too long (" +
+                             std::to_string(message.size()) + " chars)"};
+  }
+
+  if (m_unread_responses.is_closed() == true) {
+    throw std::runtime_error{"connection is shutting down"};
+  }
+
+#ifdef DEBUG
+  {
+    std::unique_lock<std::mutex> output_mutex_lock{output_mutex::output_mutex};
+    std::cerr << color_codes::foreground_red
+              << "[DEBUG]: [SENDING MESSAGE]: " << message << color_codes::reset
+              << '\n';
+  }
+#endif // DEBUG
+
+  bool is_write_needed{false};
+  {
+    std::unique_lock<std::mutex> outbound_mutex_lock{m_outbound_mutex};
+
+    std::string line{acquire_line()};
+    line.assign(message);
+
+    m_send_scheduler.push(lane, std::move(line));
+
+    // a write already requested will pick this line up too
+    if (m_is_write_requested == false) {
+      m_is_write_requested = true;
+      is_write_needed = true;
+    }
+  }
+
+  if (is_write_needed == true) {
+    request_write();
+  }
+}
+
+void vassal::irc::connection::send_text(
+    const std::string_view command, const std::span<const std::string> targets,
+    const std::string_view text) {
+  if (text.find('\0') != std::string_view::npos) {
+    throw std::runtime_error{"text contains a NUL"};
+  }
+
+  // the server relays each line with our source in front, and that has to
+  // fit in the limit too
+  const std::size_t source_length{
+      m_source_length.load(std::memory_order_relaxed)};
+  const std::size_t max_targets{get_max_targets(command)};
+  const std::size_t max_length{
+      static_cast<std::size_t>(m_k_max_message_length)};
+
+  // checked up front so nothing is queued for a bad target list
+  for (size_t i{0}; i < targets.size(); ++i) {
+    message_builder head{command};
+    head.add_param(targets[i]).append(" :");
+
+    if ((source_length + head.get_size() + m_k_min_text_length) >
+        max_length) {
+      throw std::runtime_error{"target leaves no room for text"};
+    }
+  }
+
+  if (m_unread_responses.is_closed() == true) {
+    throw std::runtime_error{"connection is shutting down"};
+  }
+
+  const send_scheduler::priority lane{send_scheduler::classify(command)};
+
+  // a line shared by several targets keeps room for the whole text if it is
+  // short, or for half a line of it if not
+  const std::size_t min_budget{std::max(
+      std::min(text.size(), (max_length / 2)), m_k_min_text_length)};
+
+  bool is_write_needed{false};
+  {
+    std::unique_lock<std::mutex> outbound_mutex_lock{m_outbound_mutex};
+
+    // every line goes in under one lock so nothing else lands between them
+    std::size_t first{0};
+    while (first < targets.size()) {
+      message_builder head{command};
+      head.add_param(targets[first]);
+
+      std::size_t count{1};
+      while (((first + count) < targets.size()) && (count < max_targets)) {
+        const std::string &target{targets[first + count]};
+        if ((source_length + head.get_size() + target.size() + 3 +
+             min_budget) > max_length) {
+          break;
+        }
+
+        head.append(",").append(target);
+        ++count;
+      }
+
+      head.append(" :");
+      push_text(lane, head.get_view(),
+                (max_length - source_length - head.get_size()), text);
+
+      first += count;
+    }
+
+    if (m_is_write_requested == false) {
+      m_is_write_requested = true;
+      is_write_needed = true;
+    }
+  }
+
+  if (is_write_needed == true) {
+    request_write();
+  }
+}
+
+bool vassal::irc::connection::send_message_pong(
+    const std::string_view possible_ping_message) {
+  const std::optional<std::string_view> ping_params{
+      framer::get_ping_params(possible_ping_message)};
+
+  if (ping_params.has_value() == false) {
+    return false;
+  }
+
+  message_builder pong_response{"PONG"};
+  if (ping_params->empty() == false) {
+    pong_response.add_param(*ping_params);
+  }
+
+  send_message(pong_response.get_view());
+
+  return true;
+}
+
+std::future<vassal::irc::reply_tracker::reply>
+vassal::irc::connection::send_query(
+    const reply_tracker::query_kind kind, const std::string_view message,
+    const std::size_t end_count, const std::chrono::milliseconds timeout,
+    reply_tracker::row_callback
+        on_row /*= reply_tracker::row_callback{}*/) {
+  std::future<reply_tracker::reply> reply{};
+
+  {
+    // queries are registered and sent under one lock so the tracker's order
+    // matches the order the server sees them in
+    std::unique_lock<std::mutex> query_mutex_lock{m_query_mutex};
+
+    const std::string label{m_reply_tracker.make_label()};
+    const std::string line{make_query_line(label, message)};
+
+    reply = m_reply_tracker.add(kind, label, message, end_count, timeout,
+                                std::move(on_row));
+    try {
+      send_message(line);
+    } catch (...) {
+      // nothing went out, so nothing will answer it
+      m_reply_tracker.remove(label);
+      throw;
+    }
+  }
+
+  update_timer();
+
+  return reply;
+}
+
+void vassal::irc::connection::send_query(
+    const reply_tracker::query_kind kind, const std::string_view message,
+    const std::size_t end_count, const std::chrono::milliseconds timeout,
+    reply_tracker::callback on_reply) {
+  {
+    std::unique_lock<std::mutex> query_mutex_lock{m_query_mutex};
+
+    const std::string label{m_reply_tracker.make_label()};
+    const std::string line{make_query_line(label, message)};
+
+    m_reply_tracker.add(kind, label, message, end_count, timeout,
+                        std::move(on_reply));
+    try {
+      send_message(line);
+    } catch (...) {
+      // a query that timed out in the meantime has already had its callback
+      // run, which must not be followed by the exception too
+      if (m_reply_tracker.remove(label) == true) {
+        throw;
+      }
+    }
+  }
+
+  update_timer();
+}
+
+bool vassal::irc::connection::add_waiter(
+    const std::coroutine_handle<> handle, const interest_filter &filter,
+    const message_predicate &predicate,
+    std::optional<message_view> *const result,
+    const std::chrono::steady_clock::time_point deadline) {
+  {
+    std::unique_lock<std::mutex> waiters_mutex_lock{m_waiters_mutex};
+
+    if (m_is_closed == true) {
+      return false;
+    }
+
+    m_waiters.push_back(waiter{handle, filter, predicate, result,
+                               m_waiter_deadlines.insert(deadline)});
+    ++m_waiter_count;
+  }
+
+  if (deadline != std::chrono::steady_clock::time_point::max()) {
+    update_timer();
+  }
+
+  return true;
+}
+
+void vassal::irc::connection::listen() {
+  // waiting in poll() rather than recv() lets the destructor wake the
+  // listener through the eventfd instead of waiting for server traffic
+  std::array<pollfd, 2> poll_fds{
+      pollfd{m_socket.get_fd(), POLLIN, 0},
+      pollfd{m_listener_thread_wakeup_fd, POLLIN, 0}};
+
+  while (m_listener_thread_kill_yourself == false) {
+    // writability only matters while a write is held up by a full socket; a
+    // paused socket isn't polled for input, and not at all unless a write is
+    // held up, or a hangup would wake the listener until a consumer made room
+    const bool is_write_requested{m_is_write_requested};
+    poll_fds[0].fd = (((m_is_reading_paused == true) &&
+                       (is_write_requested == false))
+                          ? -1
+                          : m_socket.get_fd());
+    poll_fds[0].events = static_cast<short>(
+        ((m_is_reading_paused == false) ? POLLIN : 0) |
+        ((is_write_requested == true) ? POLLOUT : 0));
+
+    const std::chrono::steady_clock::time_point next_deadline{
+        get_next_deadline()};
+    int timeout{-1};
+    if (next_deadline != std::chrono::steady_clock::time_point::max()) {
+      timeout = static_cast<int>(std::max<std::int64_t>(
+          0, std::chrono::ceil<std::chrono::milliseconds>(
+                 next_deadline - std::chrono::steady_clock::now())
+                 .count()));
+    }
+
+    const int ready{::poll(poll_fds.data(), poll_fds.size(), timeout)};
+    if (ready == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      handle_hangup();
+      return;
+    }
+
+    const std::chrono::steady_clock::time_point now{
+        std::chrono::steady_clock::now()};
+    m_reply_tracker.expire(now);
+    expire_waiters(now);
+
+    if (poll_fds[1].revents != 0) {
+      std::uint64_t value{0};
+      [[maybe_unused]] const ssize_t read{
+          ::read(m_listener_thread_wakeup_fd, &value, sizeof(value))};
+    }
+
+    // a consumer may have made room for what was held back
+    if (m_is_reading_paused == true) {
+      handle_resumed();
+    }
+
+    if ((poll_fds[0].revents & ~POLLOUT) != 0) {
+      handle_readable();
+    }
+
+    // covers lines queued from other threads, PONGs queued above and lines
+    // the scheduler held back until now
+    if (m_unread_responses.is_closed() == false) {
+      handle_writable();
+    }
+
+    if (m_unread_responses.is_closed() == true) {
+      return;
+    }
+  }
+}
+
+void vassal::irc::connection::handle_readable() {
+  for (int i{0}; i < m_k_max_reads_per_event; ++i) {
+    // the inbound queue filled up and the loop was told to stop reading
+    if (m_is_reading_paused == true) {
+      return;
+    }
+
+    const std::span<char> free_space{m_framer.prepare(m_k_read_size)};
+
+    const ssize_t received{::recv(m_socket.get_fd(), free_space.data(),
+                                  free_space.size(), MSG_DONTWAIT)};
+
+    if (received > 0) {
+      if (handle_lines(m_framer.commit(static_cast<std::size_t>(received))) ==
+          false) {
+        return;
+      }
+      if (static_cast<std::size_t>(received) < free_space.size()) {
+        return;
+      }
+    } else if (received == 0) {
+      handle_hangup();
+      return;
+    } else if (errno == EINTR) {
+      continue;
+    } else if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+      return;
+    } else {
+      handle_hangup();
+      return;
+    }
+  }
+}
+
+void vassal::irc::connection::handle_received(const std::string_view data) {
+  handle_lines(m_framer.append(data));
+}
+
+void vassal::irc::connection::handle_hangup() {
+  if (m_event_loop != nullptr) {
+    m_event_loop->remove(m_socket.get_fd());
+  }
+
+  m_unread_responses.close();
+  m_reply_tracker.close();
+  close_waiters();
+}
+
+void vassal::irc::connection::handle_writable() {
+  if ((m_event_loop != nullptr) &&
+      (m_event_loop->get_backend() == event_loop::backend::io_uring)) {
+    // the ring does the waiting, so everything the scheduler lets through
+    // goes out as one send
+    std::string data{};
+    std::chrono::steady_clock::time_point send_deadline{};
+    {
+      std::unique_lock<std::mutex> outbound_mutex_lock{m_outbound_mutex};
+
+      const std::chrono::steady_clock::time_point now{
+          std::chrono::steady_clock::now()};
+      std::string line{};
+      while (m_send_scheduler.pop(now, line) == true) {
+        data.append(line);
+        data.append(m_k_delimiter);
+        recycle_line(std::move(line));
+      }
+
+      m_is_write_requested = false;
+      m_send_deadline = m_send_scheduler.get_next_ready();
+      send_deadline = m_send_deadline;
+    }
+
+    if (data.empty() == false) {
+      m_event_loop->send(m_socket.get_fd(), std::move(data));
+    }
+    if (send_deadline != std::chrono::steady_clock::time_point::max()) {
+      update_timer();
+    }
+    return;
+  }
+
+  if (write_outbound() == false) {
+    handle_hangup();
+  }
+}
+
+void vassal::irc::connection::handle_resumed() {
+  m_is_reading_paused = false;
+
+  while (m_deferred_responses.empty() == false) {
+    if (m_unread_responses.try_push(std::move(m_deferred_responses.front())) ==
+        false) {
+      if (m_unread_responses.is_closed() == true) {
+        m_deferred_responses.clear();
+        return;
+      }
+
+      pause_reading();
+      break;
+    }
+
+    m_deferred_responses.pop_front();
+  }
+
+  m_unread_responses.publish();
+}
+
+void vassal::irc::connection::handle_timer() {
+  const std::chrono::steady_clock::time_point now{
+      std::chrono::steady_clock::now()};
+
+  m_reply_tracker.expire(now);
+  expire_waiters(now);
+  handle_writable();
+
+  update_timer();
+}
+
+bool vassal::irc::connection::handle_lines(
+    const std::span<const framer::line_span> new_lines) {
+  const receive_buffer_ref &buffer{m_framer.get_buffer()};
+
+#ifdef DEBUG
+  {
+    for (size_t i{0}; i < new_lines.size(); ++i) {
+      std::cout << color_codes::foreground_yellow
+                << "[DEBUG]: [RECEIVED MESSAGE]: "
+                << m_framer.get_line(new_lines[i]) << color_codes::reset
+                << '\n';
+    }
+  }
+#endif // DEBUG
+
+  if (m_event_loop != nullptr) {
+    m_reply_tracker.expire(std::chrono::steady_clock::now());
+  }
+
+  // answer PINGs before the rest of the batch is parsed and queued
+  for (size_t i{0}; i < new_lines.size(); ++i) {
+    if (new_lines[i].is_ping == true) {
+      // a PING that can't be echoed back (too long once it's a PONG, or
+      // holding a NUL) is left for the server to time out
+      try {
+        send_message_pong(m_framer.get_line(new_lines[i]));
+      } catch (const std::runtime_error &) {
+      }
+    }
+  }
+
+  // the filter is copied once per batch so the handlers below never hold up
+  // set_interest_filter()
+  interest_filter filter{};
+  {
+    std::unique_lock<std::mutex> interest_filter_lock{m_interest_filter_mutex};
+    filter = m_interest_filter;
+  }
+  std::size_t filtered_line_count{0};
+
+  for (size_t i{0}; i < new_lines.size(); ++i) {
+    if (new_lines[i].is_ping == true) {
+      continue;
+    }
+
+    const std::string_view line{m_framer.get_line(new_lines[i])};
+    const std::string_view command_token{framer::get_command_token(line)};
+
+    handle_own_source(line, command_token);
+    handle_isupport(line, command_token);
+
+    // query replies and waiting coroutines are served before the interest
+    // filter gets a say
+    const bool is_tracked{m_reply_tracker.is_interested(command_token)};
+    const bool is_awaited{m_waiter_count.load(std::memory_order_relaxed) !=
+                          0};
+    if ((is_tracked == false) && (is_awaited == false) &&
+        (filter.is_interested(command_token) == false)) {
+      ++filtered_line_count;
+      continue;
+    }
+
+    message_view response{buffer, line};
+
+    if ((is_tracked == true) && (m_reply_tracker.handle(response) == true)) {
+      continue;
+    }
+
+    if ((is_awaited == true) &&
+        (resume_waiter(command_token, response) == true)) {
+      continue;
+    }
+
+    if (filter.is_interested(command_token) == false) {
+      ++filtered_line_count;
+      continue;
+    }
+
+    if ((m_dispatcher != nullptr) &&
+        (m_dispatcher->dispatch(response) == true)) {
+      continue;
+    }
+
+    if (queue_response(std::move(response)) == false) {
+      return false;
+    }
+  }
+
+  m_unread_responses.publish();
+
+  if (filtered_line_count != 0) {
+    m_filtered_line_count.fetch_add(filtered_line_count,
+                                    std::memory_order_relaxed);
+  }
+
+  return true;
+}
+
+void vassal::irc::connection::handle_isupport(
+    const std::string_view line, const std::string_view command_token) {
+  static constexpr std::string_view k_isupport{"005"};
+  static constexpr std::string_view k_targmax{"TARGMAX"};
+  static constexpr std::string_view k_maxtargets{"MAXTARGETS"};
+  static constexpr std::string_view k_no_targmax{"-TARGMAX"};
+  static constexpr std::string_view k_no_maxtargets{"-MAXTARGETS"};
+  static constexpr std::string_view k_chanmodes{"CHANMODES"};
+  static constexpr std::string_view k_prefix{"PREFIX"};
+
+  if (command_token != k_isupport) {
+    return;
+  }
+
+  // "005 nick TOKEN TOKEN=value -TOKEN ... :are supported by this server",
+  // the nick is skipped along with everything else that isn't a token we use
+  std::string_view params{line.substr(
+      static_cast<std::size_t>(command_token.data() - line.data()) +
+      command_token.size())};
+
+  while (params.empty() == false) {
+    const std::size_t token_start{params.find_first_not_of(' ')};
+    if ((token_start == std::string_view::npos) ||
+        (params[token_start] == ':')) {
+      break;
+    }
+    params.remove_prefix(token_start);
+
+    const std::string_view token{params.substr(0, params.find(' '))};
+    params.remove_prefix(token.size());
+
+    const std::size_t equals{token.find('=')};
+    const std::string_view name{token.substr(0, equals)};
+    const std::string_view value{(equals == std::string_view::npos)
+                                     ? std::string_view{}
+                                     : token.substr(equals + 1)};
+
+    if (name == k_targmax) {
+      // "PRIVMSG:4,NOTICE:4,JOIN:", where a missing number means no limit
+      // and a missing command means one target
+      std::size_t max_privmsg_targets{1};
+      std::size_t max_notice_targets{1};
+      std::string_view entries{value};
+      while (entries.empty() == false) {
+        const std::string_view entry{entries.substr(0, entries.find(','))};
+        entries.remove_prefix(std::min((entry.size() + 1), entries.size()));
+
+        const std::size_t colon{entry.find(':')};
+        if (colon == std::string_view::npos) {
+          continue;
+        }
+
+        if (entry.substr(0, colon) == "PRIVMSG") {
+          max_privmsg_targets = parse_target_limit(entry.substr(colon + 1));
+        } else if (entry.substr(0, colon) == "NOTICE") {
+          max_notice_targets = parse_target_limit(entry.substr(colon + 1));
+        }
+      }
+
+      m_max_privmsg_targets.store(max_privmsg_targets,
+                                  std::memory_order_relaxed);
+      m_max_notice_targets.store(max_notice_targets, std::memory_order_relaxed);
+      m_is_targmax_known = true;
+    } else if ((name == k_maxtargets) && (m_is_targmax_known == false)) {
+      // the older token, which TARGMAX overrides
+      const std::size_t max_targets{parse_target_limit(value)};
+      m_max_privmsg_targets.store(max_targets, std::memory_order_relaxed);
+      m_max_notice_targets.store(max_targets, std::memory_order_relaxed);
+    } else if ((name == k_no_targmax) ||
+               ((name == k_no_maxtargets) && (m_is_targmax_known == false))) {
+      m_max_privmsg_targets.store(1, std::memory_order_relaxed);
+      m_max_notice_targets.store(1, std::memory_order_relaxed);
+      m_is_targmax_known = false;
+    } else if (name == k_chanmodes) {
+      // tells MODE merging which modes take a parameter
+      std::unique_lock<std::mutex> outbound_mutex_lock{m_outbound_mutex};
+      m_send_scheduler.set_channel_modes(value);
+    } else if (name == k_prefix) {
+      std::unique_lock<std::mutex> outbound_mutex_lock{m_outbound_mutex};
+      m_send_scheduler.set_prefix_modes(value);
+    }
+  }
+}
+
+bool vassal::irc::connection::queue_response(message_view &&response) {
+  // once anything is held back, later messages queue up behind it so
+  // ordering is kept
+  if ((m_deferred_responses.empty() == true) &&
+      (m_unread_responses.try_push(std::move(response)) == true)) {
+    return true;
+  }
+
+  if (m_unread_responses.is_closed() == true) {
+    return false;
+  }
+
+  m_deferred_responses.push_back(std::move(response));
+  pause_reading();
+
+  return true;
+}
+
+void vassal::irc::connection::pause_reading() {
+  if (m_is_reading_paused == true) {
+    return;
+  }
+
+  m_is_reading_paused = true;
+  if (m_event_loop != nullptr) {
+    m_event_loop->pause_reading(m_socket.get_fd());
+  }
+
+  // room may have been made before the callback was armed
+  if (m_unread_responses.arm_space_callback() == false) {
+    if (m_event_loop != nullptr) {
+      m_event_loop->resume_reading(m_socket.get_fd());
+    } else {
+      wake_listener();
+    }
+  }
+}
+
+void vassal::irc::connection::handle_own_source(
+    const std::string_view line, const std::string_view command_token) {
+  static constexpr std::string_view k_welcome{"001"};
+  static constexpr std::string_view k_join{"JOIN"};
+  static constexpr std::string_view k_nick{"NICK"};
+
+  if ((command_token != k_welcome) && (command_token != k_join) &&
+      (command_token != k_nick)) {
+    return;
+  }
+
+  // the first parameter of a NICK is the new nick, of a 001 the nick the
+  // server registered us under
+  std::string_view param{line.substr(
+      static_cast<std::size_t>(command_token.data() - line.data()) +
+      command_token.size())};
+  while (param.starts_with(' ') == true) {
+    param.remove_prefix(1);
+  }
+  if (param.starts_with(':') == true) {
+    param.remove_prefix(1);
+  }
+  param = param.substr(0, param.find(' '));
+
+  if (command_token == k_welcome) {
+    if (param.empty() == false) {
+      m_nick = param;
+      m_source_length.store(make_source_length(m_nick),
+                            std::memory_order_relaxed);
+    }
+    return;
+  }
+
+  std::string_view source{line};
+  if (source.starts_with('@') == true) {
+    source = source.substr(source.find(' ') + 1);
+  }
+  if (source.starts_with(':') == false) {
+    return;
+  }
+  source = source.substr(1, (source.find(' ') - 1));
+
+  if ((source.size() <= m_nick.size()) ||
+      (source.starts_with(m_nick) == false) ||
+      (source[m_nick.size()] != '!')) {
+    return;
+  }
+
+  // ':' and ' ' around the source
+  std::size_t source_length{source.size() + 2};
+  if (command_token == k_nick) {
+    if (param.empty() == true) {
+      return;
+    }
+    source_length = (source_length - m_nick.size() + param.size());
+    m_nick = param;
+  }
+
+  m_source_length.store(source_length, std::memory_order_relaxed);
+}
+
+void vassal::irc::connection::request_write() {
+  if (m_event_loop != nullptr) {
+    m_event_loop->request_write(m_socket.get_fd());
+  } else {
+    wake_listener();
+  }
+}
+
+void vassal::irc::connection::wake_listener() {
+  if (m_listener_thread_wakeup_fd != -1) {
+    const std::uint64_t value{1};
+    [[maybe_unused]] const ssize_t written{
+        ::write(m_listener_thread_wakeup_fd, &value, sizeof(value))};
+  }
+}
+
+bool vassal::irc::connection::write_outbound() {
+  bool is_blocked{false};
+  std::chrono::steady_clock::time_point send_deadline{};
+
+  {
+    std::unique_lock<std::mutex> outbound_mutex_lock{m_outbound_mutex};
+
+    const std::chrono::steady_clock::time_point now{
+        std::chrono::steady_clock::now()};
+
+    while (true) {
+      // lines are let through a write's worth at a time, so a full socket
+      // leaves them in the scheduler where later urgent lines can overtake
+      // them
+      std::string line{};
+      while ((m_outbound_lines.size() < m_k_max_lines_per_write) &&
+             (m_send_scheduler.pop(now, line) == true)) {
+        line.append(m_k_delimiter);
+        m_outbound_lines.push_back(std::move(line));
+      }
+
+      if (m_outbound_lines.empty() == true) {
+        break;
+      }
+
+      if (send_outbound_lines(is_blocked) == false) {
+        return false;
+      }
+      if (is_blocked == true) {
+        break;
+      }
+    }
+
+    // the request stays open while lines are held up, so nothing queued in
+    // the meantime asks again; writability brings us back, not the timer
+    if (is_blocked == false) {
+      m_is_write_requested = false;
+      m_send_deadline = m_send_scheduler.get_next_ready();
+    } else {
+      m_send_deadline = std::chrono::steady_clock::time_point::max();
+    }
+    send_deadline = m_send_deadline;
+  }
+
+  // the listener thread polls for writability and deadlines by itself
+  if (m_event_loop != nullptr) {
+    if (is_blocked == true) {
+      m_event_loop->request_write(m_socket.get_fd());
+    }
+    if (send_deadline != std::chrono::steady_clock::time_point::max()) {
+      update_timer();
+    }
+  }
+
+  return true;
+}
+
+void vassal::irc::connection::write_final(
+    const std::chrono::steady_clock::time_point deadline) {
+  std::unique_lock<std::mutex> outbound_mutex_lock{m_outbound_mutex};
+
+  // a line already partly written is finished first, or the QUIT would end
+  // up in its tail; of the rest of the backlog only urgent lines are kept,
+  // and they go out regardless of the flood limits
+  std::deque<std::string> final_lines{};
+  for (size_t i{0}; i < m_outbound_lines.size(); ++i) {
+    if (((i == 0) && (m_outbound_offset != 0)) ||
+        (send_scheduler::classify(m_outbound_lines[i]) ==
+         send_scheduler::priority::urgent)) {
+      final_lines.push_back(std::move(m_outbound_lines[i]));
+    }
+  }
+  m_outbound_lines.swap(final_lines);
+
+  std::string line{};
+  while (m_send_scheduler.pop_unpaced(send_scheduler::priority::urgent,
+                                      line) == true) {
+    line.append(m_k_delimiter);
+    m_outbound_lines.push_back(std::move(line));
+  }
+
+  while (m_outbound_lines.empty() == false) {
+    bool is_blocked{false};
+    if (send_outbound_lines(is_blocked) == false) {
+      return;
+    }
+    if (is_blocked == false) {
+      continue;
+    }
+
+    // a peer that has stopped reading gets until the deadline and no longer
+    const std::int64_t timeout{
+        std::chrono::ceil<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now())
+            .count()};
+    if (timeout <= 0) {
+      return;
+    }
+
+    pollfd poll_fd{m_socket.get_fd(), POLLOUT, 0};
+    if ((::poll(&poll_fd, 1, static_cast<int>(timeout)) == -1) &&
+        (errno != EINTR)) {
+      return;
+    }
+  }
+}
+
+bool vassal::irc::connection::send_outbound_lines(bool &is_blocked) {
+  std::array<iovec, m_k_max_lines_per_write> parts{};
+  const std::size_t part_count{
+      std::min(m_outbound_lines.size(), m_k_max_lines_per_write)};
+
+  for (size_t i{0}; i < part_count; ++i) {
+    const std::size_t offset{(i == 0) ? m_outbound_offset : 0};
+    parts[i] = iovec{(m_outbound_lines[i].data() + offset),
+                     (m_outbound_lines[i].size() - offset)};
+  }
+
+  msghdr header{};
+  header.msg_iov = parts.data();
+  header.msg_iovlen = part_count;
+
+  const ssize_t sent{::sendmsg(m_socket.get_fd(), &header,
+                               (MSG_NOSIGNAL | MSG_DONTWAIT))};
+
+  if (sent == -1) {
+    if (errno == EINTR) {
+      return true;
+    }
+    if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+      is_blocked = true;
+      return true;
+    }
+    return false;
+  }
+
+  std::size_t remaining{static_cast<std::size_t>(sent)};
+  while (remaining != 0) {
+    const std::size_t line_left{m_outbound_lines.front().size() -
+                                m_outbound_offset};
+    if (remaining < line_left) {
+      m_outbound_offset += remaining;
+      break;
+    }
+
+    remaining -= line_left;
+    recycle_line(std::move(m_outbound_lines.front()));
+    m_outbound_lines.pop_front();
+    m_outbound_offset = 0;
+  }
+
+  return true;
+}
+
+void vassal::irc::connection::push_text(const send_scheduler::priority lane,
+                                        const std::string_view head,
+                                        const std::size_t budget,
+                                        const std::string_view text) {
+  std::size_t pos{0};
+  while (pos < text.size()) {
+    const std::string_view rest{text.substr(pos)};
+    std::size_t next{0};
+    const std::size_t length{find_text_split(rest, budget, next)};
+    pos += next;
+
+    if (length == 0) {
+      continue;
+    }
+
+    std::string line{acquire_line()};
+    line.assign(head);
+    line.append(rest.substr(0, length));
+
+#ifdef DEBUG
+    {
+      std::unique_lock<std::mutex> output_mutex_lock{
+          output_mutex::output_mutex};
+      std::cerr << color_codes::foreground_red
+                << "[DEBUG]: [SENDING MESSAGE]: " << line << color_codes::reset
+                << '\n';
+    }
+#endif // DEBUG
+
+    m_send_scheduler.push(lane, std::move(line));
+  }
+}
+
+std::size_t
+vassal::irc::connection::get_max_targets(const std::string_view command) const {
+  if (command == "NOTICE") {
+    return m_max_notice_targets.load(std::memory_order_relaxed);
+  }
+  return m_max_privmsg_targets.load(std::memory_order_relaxed);
+}
+
+std::string vassal::irc::connection::acquire_line() {
+  // lines are copied into strings that have been through the queue before,
+  // so a steady stream of sends stops allocating
+  if (m_spare_lines.empty() == true) {
+    return std::string{};
+  }
+
+  std::string line{std::move(m_spare_lines.back())};
+  m_spare_lines.pop_back();
+
+  return line;
+}
+
+void vassal::irc::connection::recycle_line(std::string &&line) {
+  if (m_spare_lines.size() < m_k_max_spare_lines) {
+    line.clear();
+    m_spare_lines.push_back(std::move(line));
+  }
+}
+
+bool vassal::irc::connection::resume_waiter(
+    const std::string_view command_token, const message_view &message) {
+  std::coroutine_handle<> handle{};
+
+  {
+    std::unique_lock<std::mutex> waiters_mutex_lock{m_waiters_mutex};
+
+    for (auto it{m_waiters.begin()}; it != m_waiters.end(); ++it) {
+      if ((it->result == nullptr) ||
+          (it->filter.is_interested(command_token) == false) ||
+          (it->predicate && (it->predicate(message) == false))) {
+        continue;
+      }
+
+      *it->result = message;
+      handle = it->handle;
+
+      m_waiter_deadlines.erase(it->deadline);
+      m_waiters.erase(it);
+      --m_waiter_count;
+      break;
+    }
+  }
+
+  if (!handle) {
+    return false;
+  }
+
+  // resumed right away so a coroutine that waits again sees the very next
+  // line of this batch
+  handle.resume();
+
+  return true;
+}
+
+void vassal::irc::connection::expire_waiters(
+    const std::chrono::steady_clock::time_point now) {
+  std::vector<std::coroutine_handle<>> expired{};
+
+  {
+    std::unique_lock<std::mutex> waiters_mutex_lock{m_waiters_mutex};
+
+    if ((m_waiter_deadlines.empty() == true) ||
+        (*m_waiter_deadlines.begin() > now)) {
+      return;
+    }
+
+    for (auto it{m_waiters.begin()}; it != m_waiters.end();) {
+      if (*it->deadline > now) {
+        ++it;
+        continue;
+      }
+
+      expired.push_back(it->handle);
+
+      m_waiter_deadlines.erase(it->deadline);
+      it = m_waiters.erase(it);
+      --m_waiter_count;
+    }
+  }
+
+  for (size_t i{0}; i < expired.size(); ++i) {
+    expired[i].resume();
+  }
+}
+
+void vassal::irc::connection::close_waiters() {
+  std::list<waiter> closed{};
+
+  {
+    std::unique_lock<std::mutex> waiters_mutex_lock{m_waiters_mutex};
+
+    m_is_closed = true;
+    closed.swap(m_waiters);
+    m_waiter_deadlines.clear();
+    m_waiter_count = 0;
+  }
+
+  for (auto it{closed.begin()}; it != closed.end(); ++it) {
+    it->handle.resume();
+  }
+}
+
+std::chrono::steady_clock::time_point
+vassal::irc::connection::get_next_deadline() {
+  std::chrono::steady_clock::time_point next_deadline{
+      m_reply_tracker.get_next_deadline()};
+
+  {
+    std::unique_lock<std::mutex> waiters_mutex_lock{m_waiters_mutex};
+
+    if (m_waiter_deadlines.empty() == false) {
+      next_deadline = std::min(next_deadline, *m_waiter_deadlines.begin());
+    }
+  }
+
+  std::unique_lock<std::mutex> outbound_mutex_lock{m_outbound_mutex};
+  return std::min(next_deadline, m_send_deadline);
+}
+
+void vassal::irc::connection::update_timer() {
+  if (m_event_loop != nullptr) {
+    m_event_loop->set_timer(m_socket.get_fd(), get_next_deadline());
+  } else if (m_listener_thread_wakeup_fd != -1) {
+    // the listener may be sleeping without a deadline
+    const std::uint64_t value{1};
+    [[maybe_unused]] const ssize_t written{
+        ::write(m_listener_thread_wakeup_fd, &value, sizeof(value))};
+  }
+}
+
+std::string
+vassal::irc::connection::make_query_line(const std::string &label,
+                                         const std::string_view message) {
+  std::string line{};
+  if (label.empty() == false) {
+    line.append("@label=");
+    line.append(label);
+    line.append(" ");
+  }
+  line.append(message);
+
+  // checked before the query is registered, since one that never went out
+  // would only ever be answered by its timeout
+  if (line.size() > m_k_max_message_length) {
+    throw std::runtime_error{"message is too long (" +
+                             std::to_string(line.size()) + " chars)"};
+  }
+
+  return line;
+}
+
+liblocket::inet_socket_addr *vassal::irc::connection::make_server_address(
+    const std::string &server_address, const uint16_t port_num,
+    const liblocket::inet_socket_addr::ip_version ip_version) {
+  return ((ip_version == liblocket::inet_socket_addr::ip_version::ipv4)
+              ? (static_cast<liblocket::inet_socket_addr *>(
+                    new liblocket::inet4_socket_addr{server_address, port_num}))
+              : (static_cast<liblocket::inet_socket_addr *>(
+                    new liblocket::inet6_socket_addr{server_address,
+                                                     port_num})));
+}
+
+std::size_t
+vassal::irc::connection::make_source_length(const std::string_view nick) {
+  // ":nick!user@host " with the longest user and host servers hand out
+  return (nick.size() + m_k_assumed_user_length + m_k_assumed_host_length + 4);
+}
+
+std::size_t
+vassal::irc::connection::parse_target_limit(const std::string_view value) {
+  if (value.empty() == true) {
+    return std::numeric_limits<std::size_t>::max();
+  }
+
+  std::size_t limit{0};
+  const std::from_chars_result result{
+      std::from_chars(value.data(), (value.data() + value.size()), limit)};
+  if ((result.ec != std::errc{}) || (limit == 0)) {
+    return 1;
+  }
+
+  return limit;
+}
+
+std::size_t
+vassal::irc::connection::find_text_split(const std::string_view text,
+                                         const std::size_t budget,
+                                         std::size_t &next) {
+  const std::string_view window{text.substr(0, (budget + 1))};
+
+  // line breaks in the text always end a chunk
+  const std::size_t line_break{window.find_first_of("\r\n")};
+  if ((line_break != std::string_view::npos) && (line_break <= budget)) {
+    next = (line_break + 1);
+    return line_break;
+  }
+
+  if (text.size() <= budget) {
+    next = text.size();
+    return text.size();
+  }
+
+  // otherwise the last space that fits, which is dropped
+  const std::size_t space{window.rfind(' ')};
+  if ((space != std::string_view::npos) && (space != 0)) {
+    next = (space + 1);
+    return space;
+  }
+
+  // or failing that a cut that doesn't land inside a UTF-8 sequence
+  std::size_t length{budget};
+  while ((length > 0) &&
+         ((static_cast<unsigned char>(text[length]) & 0xC0) == 0x80)) {
+    --length;
+  }
+  if (length == 0) {
+    length = budget;
+  }
+
+  next = length;
+  return length;
+}
@@ -0,0 +1,255 @@
+#ifndef VASSAL_IRC_CONNECTION_HPP
+#define VASSAL_IRC_CONNECTION_HPP
+
+#include "irc_dispatcher.hpp"
+#include "irc_event_loop.hpp"
+#include "irc_framer.hpp"
+#include "irc_inbound_queue.hpp"
+#include "irc_interest_filter.hpp"
+#include "irc_message_slab.hpp"
+#include "irc_message_view.hpp"
+#include "irc_reply_tracker.hpp"
+#include "irc_send_scheduler.hpp"
+
+#include "liblocket/liblocket.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace vassal {
+
+namespace irc {
+// Everything that belongs to one live server connection: the socket, the
+// framing and parsing state, the inbound and outbound queues and whichever
+// of a listener thread or an event loop registration is serving them. A
+// connection never moves once constructed, so the listener thread and the
+// event loop can hold on to its address; core is the movable handle that
+// owns it.
+//
+// Sending only queues the line. The listener thread or the event loop drains
+// the outbound queue, writing everything pending with one sendmsg() where
+// the socket allows it, so callers never block on the socket. Lines reach
+// the outbound queue through the send scheduler, which holds them back by
+// priority while the flood limits are used up. Text too long for one line
+// is split across several, sized by the source the server will put in front
+// of each; the connection learns its own nick!user@host from the echoes of
+// its JOINs and NICKs and assumes the longest one until it has. Text for
+// several targets shares lines, as many targets to a line as the server's
+// TARGMAX (or MAXTARGETS) allows, and one target to a line if it says nothing.
+// A connection being destroyed gives its urgent lines (a QUIT, usually) a
+// moment to go out and drops whatever else is still queued.
+//
+// A full inbound queue never blocks the listener thread or the event loop
+// (which other connections share): the lines that didn't fit are held back
+// and the socket is left unread until a consumer makes room. PONGs and
+// queued lines keep going out in the meantime.
+//
+// Suspended coroutines wait on the connection as waiters and are resumed from
+// the listener thread or the event loop, either with the first message that
+// passes their filter and predicate or, once their deadline passes, with
+// nothing. A closing connection resumes every waiter with nothing.
+class connection : private event_loop::handler {
+public:
+  struct memory_usage {
+    std::size_t receive_buffer_bytes;
+    std::size_t message_slab_bytes;
+    std::size_t messages_in_use;
+  };
+
+  using message_predicate = std::function<bool(const message_view &message)>;
+
+private:
+  struct waiter {
+    std::coroutine_handle<> handle;
+    interest_filter filter;
+    message_predicate predicate;
+    std::optional<message_view> *result; // nullptr for plain timers
+    std::multiset<std::chrono::steady_clock::time_point>::iterator deadline;
+  };
+
+private:
+  liblocket::inet_socket_addr *m_server_address;
+  std::string m_nick;
+  std::atomic<std::size_t> m_source_length; // ":nick!user@host " as relayed
+  std::atomic<std::size_t> m_max_privmsg_targets;
+  std::atomic<std::size_t> m_max_notice_targets;
+  bool m_is_targmax_known;
+
+  liblocket::client_stream_socket m_socket;
+
+  send_scheduler m_send_scheduler;
+  std::chrono::steady_clock::time_point m_send_deadline;
+  std::deque<std::string> m_outbound_lines;
+  std::size_t m_outbound_offset; // bytes of the front line already written
+  std::vector<std::string> m_spare_lines;
+  std::mutex m_outbound_mutex;
+  std::atomic<bool> m_is_write_requested;
+
+  framer m_framer;
+  message_slab m_message_slab;
+
+  inbound_queue m_unread_responses;
+  std::deque<message_view> m_deferred_responses;
+  bool m_is_reading_paused;
+  dispatcher *m_dispatcher;
+
+  interest_filter m_interest_filter;
+  mutable std::mutex m_interest_filter_mutex;
+  std::atomic<std::size_t> m_filtered_line_count;
+
+  reply_tracker m_reply_tracker;
+  std::mutex m_query_mutex;
+
+  std::list<waiter> m_waiters;
+  std::multiset<std::chrono::steady_clock::time_point> m_waiter_deadlines;
+  std::mutex m_waiters_mutex;
+  std::atomic<std::size_t> m_waiter_count;
+  bool m_is_closed;
+
+  event_loop *m_event_loop;
+
+  std::thread m_listener_thread;
+  std::atomic<bool> m_listener_thread_kill_yourself;
+  int m_listener_thread_wakeup_fd;
+
+private:
+  static constexpr int m_k_max_message_length{510};
+  static constexpr std::string m_k_delimiter{"\r\n"};
+  static constexpr std::size_t m_k_read_size{16384};
+  static constexpr int m_k_max_reads_per_event{16};
+  static constexpr std::size_t m_k_max_lines_per_write{64};
+  static constexpr std::size_t m_k_max_spare_lines{64};
+  static constexpr std::size_t m_k_assumed_user_length{10};
+  static constexpr std::size_t m_k_assumed_host_length{63};
+  static constexpr std::size_t m_k_min_text_length{16};
+  static constexpr std::chrono::milliseconds m_k_final_write_timeout{1000};
+
+public:
+  connection(const std::string &server_address, const uint16_t port_num,
+             const std::string &nick,
+             const liblocket::inet_socket_addr::ip_version ip_version,
+             const inbound_queue::config &queue_config,
+             dispatcher *const message_dispatcher,
+             const send_scheduler::config &send_config);
+  connection(event_loop &loop, const std::string &server_address,
+             const uint16_t port_num, const std::string &nick,
+             const liblocket::inet_socket_addr::ip_version ip_version,
+             const inbound_queue::config &queue_config,
+             dispatcher *const message_dispatcher,
+             const send_scheduler::config &send_config);
+
+  connection(const connection &other) = delete;
+  connection(connection &&other) = delete;
+
+  ~connection();
+
+public:
+  message_view recv_response_view();
+  std::size_t recv_responses(const std::span<message_view> responses,
+                             const std::chrono::milliseconds timeout);
+  bool try_recv_response(message_view &response);
+
+  message_slab &get_message_slab();
+  memory_usage get_memory_usage() const;
+
+  void set_interest_filter(const interest_filter &filter);
+  interest_filter get_interest_filter() const;
+  std::size_t get_filtered_line_count() const;
+  inbound_queue::counters get_queue_counters() const;
+
+  void send_message(const std::string_view message);
+  void send_message(const std::string_view message,
+                    const send_scheduler::priority lane);
+  void send_text(const std::string_view command,
+                 const std::span<const std::string> targets,
+                 const std::string_view text);
+  bool send_message_pong(const std::string_view possible_ping_message);
+  std::future<reply_tracker::reply>
+  send_query(const reply_tracker::query_kind kind,
+             const std::string_view message, const std::size_t end_count,
+             const std::chrono::milliseconds timeout,
+             reply_tracker::row_callback on_row =
+                 reply_tracker::row_callback{});
+  void send_query(const reply_tracker::query_kind kind,
+                  const std::string_view message, const std::size_t end_count,
+                  const std::chrono::milliseconds timeout,
+                  reply_tracker::callback on_reply);
+
+  bool add_waiter(const std::coroutine_handle<> handle,
+                  const interest_filter &filter,
+                  const message_predicate &predicate,
+                  std::optional<message_view> *const result,
+                  const std::chrono::steady_clock::time_point deadline);
+
+public:
+  connection &operator=(const connection &other) = delete;
+  connection &operator=(connection &&other) = delete;
+
+private:
+  void listen();
+
+  void handle_readable() override;
+  void handle_received(const std::string_view data) override;
+  void handle_hangup() override;
+  void handle_timer() override;
+  void handle_writable() override;
+  void handle_resumed() override;
+
+  bool handle_lines(const std::span<const framer::line_span> new_lines);
+  bool queue_response(message_view &&response);
+  void pause_reading();
+  void handle_own_source(const std::string_view line,
+                         const std::string_view command_token);
+  void handle_isupport(const std::string_view line,
+                       const std::string_view command_token);
+
+  void request_write();
+  void wake_listener();
+  bool write_outbound();
+  void write_final(const std::chrono::steady_clock::time_point deadline);
+  bool send_outbound_lines(bool &is_blocked);
+  void push_text(const send_scheduler::priority lane,
+                 const std::string_view head, const std::size_t budget,
+                 const std::string_view text);
+  std::size_t get_max_targets(const std::string_view command) const;
+  std::string acquire_line();
+  void recycle_line(std::string &&line);
+
+  bool resume_waiter(const std::string_view command_token,
+                     const message_view &message);
+  void expire_waiters(const std::chrono::steady_clock::time_point now);
+  void close_waiters();
+  std::chrono::steady_clock::time_point get_next_deadline();
+  void update_timer();
+
+  static std::string make_query_line(const std::string &label,
+                                     const std::string_view message);
+  static std::size_t make_source_length(const std::string_view nick);
+  static std::size_t parse_target_limit(const std::string_view value);
+  static std::size_t find_text_split(const std::string_view text,
+                                     const std::size_t budget,
+                                     std::size_t &next);
+  static liblocket::inet_socket_addr *
+  make_server_address(const std::string &server_address,
+                      const uint16_t port_num,
+                      const liblocket::inet_socket_addr::ip_version ip_version);
+};
+} // namespace irc
+
+} // namespace vassal
+#endif
@@ -1,26 +1,33 @@
 #include "irc_core.hpp"
 
+#include "irc_any_message.hpp"
+#include "irc_connection.hpp"
+#include "irc_coroutine.hpp"
+#include "irc_dispatcher.hpp"
+#include "irc_event_loop.hpp"
+#include "irc_inbound_queue.hpp"
+#include "irc_interest_filter.hpp"
 #include "irc_message.hpp"
+#include "irc_message_builder.hpp"
+#include "irc_message_view.hpp"
 #include "irc_numeric_message.hpp"
+#include "irc_reply_tracker.hpp"
+#include "irc_send_scheduler.hpp"
 #include "irc_standard_message.hpp"
 
-#include "color_codes.hpp"
-#include "output_mutex.hpp"
-
 #include "bits-and-bytes/unreachable_error.hpp"
 #include "liblocket/liblocket.hpp"
 
+#include <algorithm>
 #include <array>
-#include <atomic>
-#include <condition_variable>
+#include <chrono>
 #include <cstddef>
-#include <deque>
-#include <exception>
-#include <iostream>
-#include <mutex>
+#include <cstdint>
+#include <future>
+#include <span>
 #include <stdexcept>
 #include <string>
-#include <thread>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -28,93 +35,120 @@ vassal::irc::core::core(const std::string &server_address, uint16_t port_num,
                         const std::string &nick, const std::string &realname,
                         liblocket::inet_socket_addr::ip_version
                             ip_version /*= inet_socket_addr::ip_version::ipv4*/,
-                        const std::string &server_password /*= ""*/)
-    : m_server_address{(
-          (ip_version == liblocket::inet_socket_addr::ip_version::ipv4)
-              ? (static_cast<liblocket::inet_socket_addr *>(
-                    new liblocket::inet4_socket_addr{server_address, port_num}))
-              : (static_cast<liblocket::inet_socket_addr *>(
-                    new liblocket::inet6_socket_addr{server_address,
-                                                     port_num})))},
-      m_nick{nick},
-      m_socket{liblocket::socket::dummy_type_connect{}, m_server_address},
-      m_unread_responses{}, m_new_unread_response{false}, m_listener_thread{},
-      m_listener_thread_kill_yourself{false} {
-  m_listener_thread = std::thread{&irc::core::listen, this};
+                        const std::string &server_password /*= ""*/,
+                        const inbound_queue::config
+                            &queue_config /*= inbound_queue::config{}*/,
+                        dispatcher *const message_dispatcher /*= nullptr*/,
+                        const send_scheduler::config
+                            &send_config /*= send_scheduler::config{}*/)
+    : m_connection{new connection{server_address, port_num, nick, ip_version,
+                                  queue_config, message_dispatcher,
+                                  send_config}} {
+  send_registration(nick, realname, server_password);
+}
 
-  if (server_password != "") {
-    send_message_pass(server_password);
-  }
-  send_message_nick(nick);
-  send_message_user(nick, realname);
+vassal::irc::core::core(event_loop &loop, const std::string &server_address,
+                        uint16_t port_num, const std::string &nick,
+                        const std::string &realname,
+                        liblocket::inet_socket_addr::ip_version
+                            ip_version /*= inet_socket_addr::ip_version::ipv4*/,
+                        const std::string &server_password /*= ""*/,
+                        const inbound_queue::config
+                            &queue_config /*= inbound_queue::config{}*/,
+                        dispatcher *const message_dispatcher /*= nullptr*/,
+                        const send_scheduler::config
+                            &send_config /*= send_scheduler::config{}*/)
+    : m_connection{new connection{loop, server_address, port_num, nick,
+                                  ip_version, queue_config, message_dispatcher,
+                                  send_config}} {
+  send_registration(nick, realname, server_password);
 }
 
-vassal::irc::core::core(core &&other)
-    : m_server_address{other.m_server_address}, m_nick{std::move(other.m_nick)},
-      m_socket{std::move(other.m_socket)}, m_unread_responses{},
-      m_new_unread_response{std::move(other.m_new_unread_response.load())},
-      m_listener_thread{std::move(other.m_listener_thread)},
-      m_listener_thread_kill_yourself{
-          std::move(other.m_listener_thread_kill_yourself.load())} {
-  other.m_server_address = nullptr;
+vassal::irc::core::core(core &&other) noexcept
+    : m_connection{std::move(other.m_connection)} {}
 
-  m_unread_responses.resize(other.m_unread_responses.size(), nullptr);
-  for (size_t i{0}; i < other.m_unread_responses.size(); ++i) {
-    m_unread_responses[i] = other.m_unread_responses[i];
-    other.m_unread_responses[i] = nullptr;
-  }
+vassal::irc::core::~core() {}
+
+vassal::irc::message *vassal::irc::core::recv_response() {
+  return recv_response_view().to_message(m_connection->get_message_slab());
 }
 
-vassal::irc::core::~core() {
-  m_listener_thread_kill_yourself = true;
-  m_listener_thread.join();
+vassal::irc::message_view vassal::irc::core::recv_response_view() {
+  return m_connection->recv_response_view();
+}
+
+vassal::irc::any_message vassal::irc::core::recv_response_value() {
+  return recv_response_view().to_any_message();
+}
 
-  delete m_server_address;
-  m_server_address = nullptr;
+std::size_t vassal::irc::core::recv_responses(
+    const std::span<message_view> responses,
+    const std::chrono::milliseconds
+        timeout /*= std::chrono::milliseconds::max()*/) {
+  return m_connection->recv_responses(responses, timeout);
+}
 
-  for (size_t i{0}; i < m_unread_responses.size(); ++i) {
-    delete m_unread_responses[i];
-    m_unread_responses[i] = nullptr;
+std::size_t vassal::irc::core::recv_responses(
+    std::vector<message_view> &responses, const std::size_t max_count,
+    const std::chrono::milliseconds
+        timeout /*= std::chrono::milliseconds::max()*/) {
+  const std::size_t old_size{responses.size()};
+  responses.resize(old_size + max_count);
+
+  std::size_t count{0};
+  try {
+    count = recv_responses(
+        std::span<message_view>{responses}.subspan(old_size), timeout);
+  } catch (...) {
+    responses.resize(old_size);
+    throw;
   }
+
+  responses.resize(old_size + count);
+  return count;
 }
 
-vassal::irc::message *vassal::irc::core::recv_response() {
-  while (true) {
-    std::unique_lock<std::mutex> m_unread_responses_mutex_lock{
-        m_unread_responses_mutex};
-    m_unread_responses_cv.wait(m_unread_responses_mutex_lock, [this] {
-      return m_new_unread_response == true;
-    });
-
-    if (m_unread_responses.size() == 0) {
-      m_new_unread_response = false;
-      continue;
-    }
+bool vassal::irc::core::try_recv_response(message_view &response) {
+  return m_connection->try_recv_response(response);
+}
+
+vassal::irc::core::memory_usage vassal::irc::core::get_memory_usage() const {
+  return m_connection->get_memory_usage();
+}
 
-    message *temp{m_unread_responses.front()};
-    m_unread_responses.front() = nullptr;
-    m_unread_responses.pop_front();
+void vassal::irc::core::set_interest_filter(const interest_filter &filter) {
+  m_connection->set_interest_filter(filter);
+}
 
-    return temp;
-  }
+vassal::irc::interest_filter vassal::irc::core::get_interest_filter() const {
+  return m_connection->get_interest_filter();
+}
+
+std::size_t vassal::irc::core::get_filtered_line_count() const {
+  return m_connection->get_filtered_line_count();
+}
+
+vassal::irc::inbound_queue::counters
+vassal::irc::core::get_queue_counters() const {
+  return m_connection->get_queue_counters();
 }
 
 void vassal::irc::core::send_message_pass(const std::string &password) {
-  std::string message{std::string{"PASS "} + password};
-  send_message(message);
+  message_builder message{"PASS"};
+  message.add_param(password);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_nick(const std::string &nickname) {
-  std::string message{std::string{"NICK "} + nickname};
-  send_message(message);
+  message_builder message{"NICK"};
+  message.add_param(nickname);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_user(
     const std::string &username, const std::string &realname,
     const std::pair<user_mode, user_mode>
         modes /*= {user_mode::N, user_mode::N}*/) {
-  std::string message{std::string{"USER "} + username + " "};
-
   static constexpr uint8_t k_bitmask_user_mode_i{0b1000};
   static constexpr uint8_t k_bitmask_user_mode_w{0b0100};
   uint8_t modes_bitmask{0};
@@ -139,16 +173,20 @@ void vassal::irc::core::send_message_user(
   set_bitmask(modes.first);
   set_bitmask(modes.second);
 
-  message.append(
-      std::string{std::to_string(modes_bitmask) + " * :" + realname});
+  message_builder message{"USER"};
+  message.add_param(username)
+      .add_param(modes_bitmask)
+      .add_param("*")
+      .add_trailing(realname);
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_oper(const std::string &name,
                                           const std::string &password) {
-  std::string message{std::string{"OPER "} + name + " " + password};
-  send_message(message);
+  message_builder message{"OPER"};
+  message.add_param(name).add_param(password);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_user_mode(
@@ -185,13 +223,15 @@ void vassal::irc::core::send_message_user_mode(
       break;
     }
 
-    std::string message{std::string{"MODE "} + nickname + " " +
-                        m_k_mode_operation_lut[static_cast<size_t>(operation)] +
-                        m_k_user_mode_lut[static_cast<size_t>(mode)]};
-    send_message(message);
+    message_builder message{"MODE"};
+    message.add_param(nickname)
+        .add_param(make_flag(m_k_mode_operation_lut, operation))
+        .append(make_flag(m_k_user_mode_lut, mode));
+    send_message(message.get_view());
   } else if ((mode == user_mode::N) && (operation == mode_operation::N)) {
-    std::string message{std::string{"MODE "} + nickname};
-    send_message(message);
+    message_builder message{"MODE"};
+    message.add_param(nickname);
+    send_message(message.get_view());
   } else if ((mode == user_mode::N) && (operation != mode_operation::N)) {
     throw std::runtime_error{"mode is not specified"};
   } else if ((mode != user_mode::N) && (operation == mode_operation::N)) {
@@ -202,32 +242,35 @@ void vassal::irc::core::send_message_user_mode(
 }
 
 void vassal::irc::core::send_message_quit(const std::string &quit_message) {
-  std::string message{std::string{"QUIT :"} + quit_message};
-  send_message(message);
+  message_builder message{"QUIT"};
+  message.add_trailing(quit_message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_squit(const std::string &server,
                                            const std::string &comment) {
-  std::string message{std::string{"SQUIT "} + server + " :" + comment};
-  send_message(message);
+  message_builder message{"SQUIT"};
+  message.add_param(server).add_trailing(comment);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_join(const std::string &channel,
                                           const std::string &key /*= ""*/) {
-  std::string message{std::string{"JOIN "} + channel};
+  message_builder message{"JOIN"};
+  message.add_param(channel);
 
   if (key != "") {
-    message.append(" ");
-    message.append(key);
+    message.add_param(key);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_join(
     const std::vector<std::pair<std::string, std::string>> &channels_and_keys) {
-  std::string message{"JOIN "};
+  message_builder message{"JOIN"};
 
+  message.append(" ");
   for (size_t i{0}; i < channels_and_keys.size(); ++i) {
     if ((i > 0) && (channels_and_keys[i].first != "")) {
       message.append(",");
@@ -236,7 +279,6 @@ void vassal::irc::core::send_message_join(
   }
 
   message.append(" ");
-
   for (size_t i{0}; i < channels_and_keys.size(); ++i) {
     if ((i > 0) && (channels_and_keys[i].second != "")) {
       message.append(",");
@@ -244,188 +286,145 @@ void vassal::irc::core::send_message_join(
     message.append(channels_and_keys[i].second);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_part(
     const std::string &channel, const std::string &part_message /*= ""*/) {
-  std::string message{std::string{"PART "} + channel};
+  message_builder message{"PART"};
+  message.add_param(channel);
 
   if (part_message != "") {
-    message.append(std::string{" :"} + part_message);
+    message.add_trailing(part_message);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_part(
     const std::vector<std::string> &channels,
     const std::string &part_message /*= ""*/) {
-  std::string message{"PART "};
-
-  for (size_t i{0}; i < channels.size(); ++i) {
-    if ((i > 0) && (channels[i] != "")) {
-      message.append(",");
-    }
-    message.append(channels[i]);
-  }
+  message_builder message{"PART"};
+  message.add_list(channels);
 
   if (part_message != "") {
-    message.append(std::string{" :"} + part_message);
+    message.add_trailing(part_message);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_part_all() {
-  std::string message{"JOIN 0"};
-  send_message(message);
+  message_builder message{"JOIN"};
+  message.add_param("0");
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_channel_mode(
     const std::string &channel, const channel_mode mode,
     const mode_operation operation /*= mode_operation::N*/,
     const std::string &options /*= ""*/) {
-  std::string message{std::string{"MODE "} + channel};
+  message_builder message{"MODE"};
+  message.add_param(channel);
 
   if (operation != mode_operation::N) {
-    message.append(std::string{" "} +
-                   m_k_mode_operation_lut[static_cast<size_t>(operation)]);
+    message.add_param(make_flag(m_k_mode_operation_lut, operation));
   }
 
-  message.append(std::string{m_k_channel_mode_lut[static_cast<size_t>(mode)]});
+  message.append(make_flag(m_k_channel_mode_lut, mode));
 
   if (options != "") {
-    message.append(std::string{" "} + options);
+    message.add_param(options);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_topic(const std::string &channel,
                                            const std::string &topic /*= ""*/) {
-  std::string message{std::string{"TOPIC "} + channel};
+  message_builder message{"TOPIC"};
+  message.add_param(channel);
 
   if (topic != "") {
-    message.append(std::string{" :" + topic});
+    message.add_trailing(topic);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_names(const std::string &channel /*= ""*/,
                                            const std::string &target /*= ""*/) {
-  std::string message{"NAMES"};
-
-  if (channel != "") {
-    message.append(std::string{" "} + channel);
-
-    if (target != "") {
-      message.append(std::string{" "} + target);
-    }
-  }
-
-  send_message(message);
+  send_message(make_message_names(channel, target).get_view());
 }
 
 void vassal::irc::core::send_message_names(
     const std::vector<std::string> &channels /*= {}*/,
     const std::string &target /*= ""*/) {
-  std::string message{"NAMES"};
+  message_builder message{"NAMES"};
 
   if (channels.size() != 0) {
-    message.append(" ");
-
-    for (size_t i{0}; i < channels.size(); ++i) {
-      if ((i > 0) && (channels[i] != "")) {
-        message.append(",");
-      }
-
-      message.append(channels[i]);
-    }
+    message.add_list(channels);
 
     if (target != "") {
-      message.append(std::string{" "} + target);
+      message.add_param(target);
     }
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_list(const std::string &channel /*= ""*/,
                                           const std::string &target /*= ""*/) {
-  std::string message{"LIST"};
-
-  if (channel != "") {
-    message.append(std::string{" "} + channel);
-
-    if (target != "") {
-      message.append(std::string{" "} + target);
-    }
-  }
-
-  send_message(message);
+  send_message(make_message_list(channel, target).get_view());
 }
 
 void vassal::irc::core::send_message_list(
     const std::vector<std::string> &channels /*= {}*/,
     const std::string &target /*= ""*/) {
-  std::string message{"LIST"};
+  message_builder message{"LIST"};
 
   if (channels.size() != 0) {
-    message.append(" ");
-
-    for (size_t i{0}; i < channels.size(); ++i) {
-      if ((i > 0) && (channels[i] != "")) {
-        message.append(",");
-      }
-
-      message.append(channels[i]);
-    }
+    message.add_list(channels);
 
     if (target != "") {
-      message.append(std::string{" "} + target);
+      message.add_param(target);
     }
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_invite(const std::string &nickname,
                                             const std::string &channel) {
-  std::string message{"INVITE " + nickname + " " + channel};
-  send_message(message);
+  message_builder message{"INVITE"};
+  message.add_param(nickname).add_param(channel);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_kick(const std::string &channel,
                                           const std::string &user,
                                           const std::string &comment /*= ""*/) {
-  std::string message{"KICK " + channel + " " + user};
+  message_builder message{"KICK"};
+  message.add_param(channel).add_param(user);
 
   if (comment != "") {
-    message.append(std::string{" :" + comment});
+    message.add_trailing(comment);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_kick(const std::string &channel,
                                           const std::vector<std::string> &users,
                                           const std::string &comment /*= ""*/) {
-  std::string message{"KICK " + channel + " "};
-
-  for (size_t i{0}; i < users.size(); ++i) {
-    if ((i > 0) && (users[i] != "")) {
-      message.append(",");
-    }
-    message.append(users[i]);
-  }
+  message_builder message{"KICK"};
+  message.add_param(channel).add_list(users);
 
   if (comment != "") {
-    message.append(std::string{" :" + comment});
+    message.add_trailing(comment);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_kick(
@@ -437,360 +436,295 @@ void vassal::irc::core::send_message_kick(
                              "parameters must be the same"};
   }
 
-  std::string message{"KICK "};
-
-  for (size_t i{0}; i < channels.size(); ++i) {
-    if ((i > 0) && (channels[i] != "")) {
-      message.append(",");
-    }
-    message.append(users[i]);
-  }
-
-  message.append(" ");
-
-  for (size_t i{0}; i << users.size(); ++i) {
-    if ((i > 0) && (users[i] != "")) {
-      message.append(",");
-    }
-    message.append(users[i]);
-  }
+  message_builder message{"KICK"};
+  message.add_list(channels).add_list(users);
 
   if (comment != "") {
-    message.append(std::string{" :" + comment});
+    message.add_trailing(comment);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_privmsg(
     const std::string &receiver, const std::string &text_to_be_sent) {
-  std::string message{std::string{"PRIVMSG "} + receiver + " :" +
-                      text_to_be_sent};
-  send_message(message);
+  m_connection->send_text("PRIVMSG", std::span<const std::string>{&receiver, 1},
+                          text_to_be_sent);
+}
+
+void vassal::irc::core::send_message_privmsg(
+    const std::vector<std::string> &receivers,
+    const std::string &text_to_be_sent) {
+  m_connection->send_text("PRIVMSG", receivers, text_to_be_sent);
 }
 
 void vassal::irc::core::send_message_notice(
     const std::string &receiver, const std::string &text_to_be_sent) {
-  std::string message{std::string{"PRIVMSG "} + receiver + " :" +
-                      text_to_be_sent};
-  send_message(message);
+  m_connection->send_text("NOTICE", std::span<const std::string>{&receiver, 1},
+                          text_to_be_sent);
+}
+
+void vassal::irc::core::send_message_notice(
+    const std::vector<std::string> &receivers,
+    const std::string &text_to_be_sent) {
+  m_connection->send_text("NOTICE", receivers, text_to_be_sent);
 }
 
 void vassal::irc::core::send_message_motd(const std::string &target /*= ""*/) {
-  std::string message{"MOTD"};
+  message_builder message{"MOTD"};
 
   if (target != "") {
-    message.append(std::string{" " + target});
+    message.add_param(target);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_lusers(
     const std::string &mask /*= ""*/, const std::string &target /*= ""*/) {
-  std::string message{"LUSERS"};
+  message_builder message{"LUSERS"};
 
   if (mask != "") {
-    message.append(std::string{" " + mask});
+    message.add_param(mask);
 
     if (target != "") {
-      message.append(std::string{" " + target});
+      message.add_param(target);
     }
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_version(
     const std::string &target /*= ""*/) {
-  std::string message{"VERSION"};
+  message_builder message{"VERSION"};
 
   if (target != "") {
-    message.append(std::string{" " + target});
+    message.add_param(target);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_stats(
     stats_query query /*= stats_query::N*/,
     const std::string &target /*= ""*/) {
-  std::string message{"STATS"};
-
-  if (query != stats_query::N) {
-    message.append(std::string{" "} +
-                   m_k_stats_query_lut[static_cast<size_t>(query)]);
-
-    if (target != "") {
-      message.append(std::string{" " + target});
-    }
-  }
-
-  send_message(message);
+  send_message(make_message_stats(query, target).get_view());
 }
 
 void vassal::irc::core::send_message_links(
     const std::string &remote_server /*= ""*/,
     const std::string &server_mask /*= ""*/) {
-  std::string message{"LINKS"};
+  message_builder message{"LINKS"};
 
   if (server_mask != "") {
     if (remote_server != "") {
-      message.append({" " + remote_server});
+      message.add_param(remote_server);
     }
 
-    message.append(std::string{" " + server_mask});
+    message.add_param(server_mask);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_time(const std::string &target /*= ""*/) {
-  std::string message{"TIME"};
+  message_builder message{"TIME"};
 
   if (target != "") {
-    message.append(std::string{" " + target});
+    message.add_param(target);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_connect(
     const std::string &target_server, const std::string &port,
     const std::string &remote_server /*= ""*/) {
-  std::string message{std::string{"CONNECT "} + target_server + " " + port};
+  message_builder message{"CONNECT"};
+  message.add_param(target_server).add_param(port);
 
   if (remote_server != "") {
-    message.append(std::string{" " + remote_server});
+    message.add_param(remote_server);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_trace(const std::string &target /*= ""*/) {
-  std::string message{"TRACE"};
+  message_builder message{"TRACE"};
 
   if (target != "") {
-    message.append(std::string{" " + target});
+    message.add_param(target);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_admin(const std::string &target /*= ""*/) {
-  std::string message{"ADMIN"};
+  message_builder message{"ADMIN"};
 
   if (target != "") {
-    message.append(std::string{" " + target});
+    message.add_param(target);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_info(const std::string &target /*= ""*/) {
-  std::string message{"INFO"};
+  message_builder message{"INFO"};
 
   if (target != "") {
-    message.append(std::string{" " + target});
+    message.add_param(target);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_servlist(
     const std::string &mask /*= ""*/, const std::string &type /*= ""*/) {
-  std::string message{"SERVLIST"};
+  message_builder message{"SERVLIST"};
 
   if (mask != "") {
-    message.append(std::string{" " + mask});
+    message.add_param(mask);
 
     if (type != "") {
-      message.append(std::string{" " + type});
+      message.add_param(type);
     }
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_squery(const std::string &service_name,
                                             const std::string &text) {
-  std::string message{std::string{"SQUERY "} + service_name + " " + text};
-  send_message(message);
+  message_builder message{"SQUERY"};
+  message.add_param(service_name).add_param(text);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_who(const std::string &mask /*= ""*/,
                                          bool only_opers /*= false*/) {
-  std::string message{"WHO"};
-
-  if (mask != "") {
-    message.append(std::string{" " + mask});
-
-    if (only_opers == true) {
-      message.append(" o");
-    }
-  }
-
-  send_message(message);
+  send_message(make_message_who(mask, only_opers).get_view());
 }
 
 void vassal::irc::core::send_message_whois(const std::string &mask,
                                            const std::string &target /*= ""*/) {
-  std::string message{"WHOIS "};
-
-  if (target != "") {
-    message.append(std::string{target + " "});
-  }
-
-  message.append(mask);
-
-  send_message(message);
+  send_message(make_message_whois(mask, target).get_view());
 }
 
 void vassal::irc::core::send_message_whois(
     const std::vector<std::string> &masks, const std::string &target /*= ""*/) {
-  std::string message{"WHOIS "};
+  message_builder message{"WHOIS"};
 
   if (target != "") {
-    message.append(std::string{target + " "});
+    message.add_param(target);
   }
 
-  for (size_t i{0}; i < masks.size(); ++i) {
-    if ((i > 0) && (masks[i] != "")) {
-      message.append(",");
-    }
-
-    message.append(masks[i]);
-  }
+  message.add_list(masks);
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_whowas(
     const std::string &nickname, const int count /*= -1*/,
     const std::string &target /*= ""*/) {
-  std::string message{"WHOWAS " + nickname};
+  message_builder message{"WHOWAS"};
+  message.add_param(nickname);
 
   if (count != -1) {
-    message.append(std::string{" " + std::to_string(count)});
+    message.add_param(count);
 
     if (target != "") {
-      message.append(std::string{" " + target});
+      message.add_param(target);
     }
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_whowas(
     const std::vector<std::string> &nicknames, const int count /*= -1*/,
     const std::string &target /*= ""*/) {
-  std::string message{"WHOWAS "};
-
-  for (size_t i{0}; i < nicknames.size(); ++i) {
-    if ((i > 0) && (nicknames[i] != "")) {
-      message.append(",");
-    }
-    message.append(nicknames[i]);
-  }
+  message_builder message{"WHOWAS"};
+  message.add_list(nicknames);
 
   if (count != -1) {
-    message.append(std::string{" " + std::to_string(count)});
+    message.add_param(count);
 
     if (target != "") {
-      message.append(std::string{" " + target});
+      message.add_param(target);
     }
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_kill(const std::string &nickname,
                                           const std::string &comment) {
-  std::string message{std::string{"KILL "} + nickname + " :" + comment};
-  send_message(message);
+  message_builder message{"KILL"};
+  message.add_param(nickname).add_trailing(comment);
+  send_message(message.get_view());
 }
 
 bool vassal::irc::core::send_message_pong(
-    const std::string &possible_ping_message) {
-  static constexpr std::string k_ping{"PING"};
-  static constexpr std::string k_pong{"PONG"};
-
-  std::string::size_type pos{possible_ping_message.find(k_ping)};
-
-  if (pos != std::string::npos) {
-    if (possible_ping_message.find(std::string{k_ping + " :"}) !=
-        std::string::npos) {
-      std::string pong_response{k_pong};
-      pong_response.append(possible_ping_message.substr(pos + k_ping.size()));
-
-      send_message(pong_response);
-
-      return true;
-    }
-  }
-
-  return false;
+    const std::string_view possible_ping_message) {
+  return m_connection->send_message_pong(possible_ping_message);
 }
 
 void vassal::irc::core::send_message_away(const std::string &text /*= ""*/) {
-  std::string message{"AWAY"};
+  message_builder message{"AWAY"};
 
   if (text != "") {
-    message.append(std::string{" :" + text});
+    message.add_trailing(text);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
-void vassal::irc::core::send_message_rehash() {
-  std::string message{"REHASH"};
-  send_message(message);
-}
+void vassal::irc::core::send_message_rehash() { send_message("REHASH"); }
 
-void vassal::irc::core::send_message_die() {
-  std::string message{"DIE"};
-  send_message(message);
-}
+void vassal::irc::core::send_message_die() { send_message("DIE"); }
 
-void vassal::irc::core::send_message_restart() {
-  std::string message{"RESTART"};
-  send_message(message);
-}
+void vassal::irc::core::send_message_restart() { send_message("RESTART"); }
 
 void vassal::irc::core::send_message_summon(
     const std::string &user, const std::string &target /*= ""*/,
     const std::string &channel /*= ""*/) {
-  std::string message{std::string{"MESSAGE "} + user};
+  message_builder message{"SUMMON"};
+  message.add_param(user);
 
   if (target != "") {
-    message.append(std::string{" " + target});
+    message.add_param(target);
 
     if (channel != "") {
-      message.append(std::string{" " + channel});
+      message.add_param(channel);
     }
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_users(const std::string &target /*= ""*/) {
-  std::string message{"USERS"};
+  message_builder message{"USERS"};
 
   if (target != "") {
-    message.append(std::string{" " + target});
+    message.add_param(target);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_wallops(const std::string &text) {
-  std::string message{"WALLOPS :" + text};
-  send_message(message);
+  message_builder message{"WALLOPS"};
+  message.add_trailing(text);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_userhost(const std::string &nickname) {
-  std::string message{std::string{"USERHOST "} + nickname};
-  send_message(message);
+  message_builder message{"USERHOST"};
+  message.add_param(nickname);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_userhost(
@@ -802,171 +736,300 @@ void vassal::irc::core::send_message_userhost(
         "USERHOST can only accept a list of up to 5 nicknames"};
   }
 
-  std::string message{"USERHOST"};
+  message_builder message{"USERHOST"};
 
   for (size_t i{0}; i < nicknames.size(); ++i) {
-    message.append(std::string{" " + nicknames[i]});
+    message.add_param(nicknames[i]);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_ison(const std::string &nickname) {
-  std::string message{std::string{"ISON "} + nickname};
-  send_message(message);
+  message_builder message{"ISON"};
+  message.add_param(nickname);
+  send_message(message.get_view());
 }
 
 void vassal::irc::core::send_message_ison(
     const std::vector<std::string> &nicknames) {
-  std::string message{"ISON"};
+  message_builder message{"ISON"};
 
   for (size_t i{0}; i < nicknames.size(); ++i) {
-    message.append(std::string{" " + nicknames[i]});
+    message.add_param(nicknames[i]);
   }
 
-  send_message(message);
+  send_message(message.get_view());
 }
 
-vassal::irc::core &vassal::irc::core::operator=(core &&other) {
-  if (this == &other) {
-    return *this;
-  }
+std::future<vassal::irc::reply_tracker::reply>
+vassal::irc::core::query_names(const std::string &channel /*= ""*/,
+                               const std::string &target /*= ""*/,
+                               const std::chrono::milliseconds
+                                   timeout /*= m_k_default_query_timeout*/) {
+  const message_builder message{make_message_names(channel, target)};
+  return m_connection->send_query(reply_tracker::query_kind::names,
+                                  message.get_view(),
+                                  make_end_count_names(channel), timeout);
+}
 
-  delete m_server_address;
-  m_server_address = nullptr;
-  m_server_address = other.m_server_address;
-  other.m_server_address = nullptr;
+std::future<vassal::irc::reply_tracker::reply>
+vassal::irc::core::query_list(const std::string &channel /*= ""*/,
+                              const std::string &target /*= ""*/,
+                              const std::chrono::milliseconds
+                                  timeout /*= m_k_default_query_timeout*/) {
+  const message_builder message{make_message_list(channel, target)};
+  return m_connection->send_query(reply_tracker::query_kind::list,
+                                  message.get_view(), 1, timeout);
+}
 
-  m_nick = std::move(other.m_nick);
-  m_socket = std::move(other.m_socket);
+std::future<vassal::irc::reply_tracker::reply>
+vassal::irc::core::query_stats(const stats_query query,
+                               const std::string &target /*= ""*/,
+                               const std::chrono::milliseconds
+                                   timeout /*= m_k_default_query_timeout*/) {
+  const message_builder message{make_message_stats(query, target)};
+  return m_connection->send_query(reply_tracker::query_kind::stats,
+                                  message.get_view(), 1, timeout);
+}
 
-  for (size_t i{0}; i < m_unread_responses.size(); ++i) {
-    delete m_unread_responses[i];
-    m_unread_responses[i] = nullptr;
-  }
-  m_unread_responses.resize(other.m_unread_responses.size(), nullptr);
-  for (size_t i{0}; i < m_unread_responses.size(); ++i) {
-    m_unread_responses[i] = other.m_unread_responses[i];
-    other.m_unread_responses[i] = nullptr;
-    ;
+std::future<vassal::irc::reply_tracker::reply>
+vassal::irc::core::query_who(const std::string &mask /*= ""*/,
+                             bool only_opers /*= false*/,
+                             const std::chrono::milliseconds
+                                 timeout /*= m_k_default_query_timeout*/) {
+  const message_builder message{make_message_who(mask, only_opers)};
+  return m_connection->send_query(reply_tracker::query_kind::who,
+                                  message.get_view(), 1, timeout);
+}
+
+std::future<vassal::irc::reply_tracker::reply>
+vassal::irc::core::query_whois(const std::string &mask,
+                               const std::string &target /*= ""*/,
+                               const std::chrono::milliseconds
+                                   timeout /*= m_k_default_query_timeout*/) {
+  const message_builder message{make_message_whois(mask, target)};
+  return m_connection->send_query(reply_tracker::query_kind::whois,
+                                  message.get_view(), 1, timeout);
+}
+
+std::future<vassal::irc::reply_tracker::reply>
+vassal::irc::core::stream_names(const reply_tracker::row_callback &on_row,
+                                const std::string &channel /*= ""*/,
+                                const std::string &target /*= ""*/,
+                                const std::chrono::milliseconds
+                                    timeout /*= m_k_default_query_timeout*/) {
+  const message_builder message{make_message_names(channel, target)};
+  return m_connection->send_query(reply_tracker::query_kind::names,
+                                  message.get_view(),
+                                  make_end_count_names(channel), timeout,
+                                  on_row);
+}
+
+std::future<vassal::irc::reply_tracker::reply>
+vassal::irc::core::stream_list(const reply_tracker::row_callback &on_row,
+                               const std::string &channel /*= ""*/,
+                               const std::string &target /*= ""*/,
+                               const std::chrono::milliseconds
+                                   timeout /*= m_k_default_query_timeout*/) {
+  const message_builder message{make_message_list(channel, target)};
+  return m_connection->send_query(reply_tracker::query_kind::list,
+                                  message.get_view(), 1, timeout, on_row);
+}
+
+std::future<vassal::irc::reply_tracker::reply>
+vassal::irc::core::stream_who(const reply_tracker::row_callback &on_row,
+                              const std::string &mask /*= ""*/,
+                              bool only_opers /*= false*/,
+                              const std::chrono::milliseconds
+                                  timeout /*= m_k_default_query_timeout*/) {
+  const message_builder message{make_message_who(mask, only_opers)};
+  return m_connection->send_query(reply_tracker::query_kind::who,
+                                  message.get_view(), 1, timeout, on_row);
+}
+
+vassal::irc::message_awaitable vassal::irc::core::next_message(
+    const interest_filter &filter /*= interest_filter{}*/,
+    const connection::message_predicate
+        &predicate /*= connection::message_predicate{}*/,
+    const std::chrono::milliseconds
+        timeout /*= std::chrono::milliseconds::max()*/) {
+  return message_awaitable{m_connection.get(), filter, predicate, timeout};
+}
+
+vassal::irc::reply_awaitable
+vassal::irc::core::await_names(const std::string &channel /*= ""*/,
+                               const std::string &target /*= ""*/,
+                               const std::chrono::milliseconds
+                                   timeout /*= m_k_default_query_timeout*/) {
+  const message_builder message{make_message_names(channel, target)};
+  return reply_awaitable{m_connection.get(), reply_tracker::query_kind::names,
+                         message.get_view(), make_end_count_names(channel),
+                         timeout};
+}
+
+vassal::irc::reply_awaitable
+vassal::irc::core::await_list(const std::string &channel /*= ""*/,
+                              const std::string &target /*= ""*/,
+                              const std::chrono::milliseconds
+                                  timeout /*= m_k_default_query_timeout*/) {
+  const message_builder message{make_message_list(channel, target)};
+  return reply_awaitable{m_connection.get(), reply_tracker::query_kind::list,
+                         message.get_view(), 1, timeout};
+}
+
+vassal::irc::reply_awaitable
+vassal::irc::core::await_stats(const stats_query query,
+                               const std::string &target /*= ""*/,
+                               const std::chrono::milliseconds
+                                   timeout /*= m_k_default_query_timeout*/) {
+  const message_builder message{make_message_stats(query, target)};
+  return reply_awaitable{m_connection.get(), reply_tracker::query_kind::stats,
+                         message.get_view(), 1, timeout};
+}
+
+vassal::irc::reply_awaitable
+vassal::irc::core::await_who(const std::string &mask /*= ""*/,
+                             bool only_opers /*= false*/,
+                             const std::chrono::milliseconds
+                                 timeout /*= m_k_default_query_timeout*/) {
+  const message_builder message{make_message_who(mask, only_opers)};
+  return reply_awaitable{m_connection.get(), reply_tracker::query_kind::who,
+                         message.get_view(), 1, timeout};
+}
+
+vassal::irc::reply_awaitable
+vassal::irc::core::await_whois(const std::string &mask,
+                               const std::string &target /*= ""*/,
+                               const std::chrono::milliseconds
+                                   timeout /*= m_k_default_query_timeout*/) {
+  const message_builder message{make_message_whois(mask, target)};
+  return reply_awaitable{m_connection.get(), reply_tracker::query_kind::whois,
+                         message.get_view(), 1, timeout};
+}
+
+vassal::irc::timer_awaitable
+vassal::irc::core::sleep_for(const std::chrono::milliseconds duration) {
+  return timer_awaitable{m_connection.get(), duration};
+}
+
+vassal::irc::core &vassal::irc::core::operator=(core &&other) noexcept {
+  if (this == &other) {
+    return *this;
   }
 
-  m_new_unread_response = std::move(other.m_new_unread_response.load());
-  m_listener_thread = std::move(other.m_listener_thread);
-  m_listener_thread_kill_yourself =
-      std::move(other.m_listener_thread_kill_yourself.load());
+  m_connection = std::move(other.m_connection);
 
   return *this;
 }
 
-void vassal::irc::core::listen() {
-  std::string message_fragment{""};
+void vassal::irc::core::send_message(const std::string_view message) {
+  m_connection->send_message(message);
+}
 
-  while (m_listener_thread_kill_yourself == false) {
-    std::string received_message{m_socket.recv()};
-    if (message_fragment != "") {
-      received_message.insert(0, message_fragment);
-    }
+void vassal::irc::core::send_message(const std::string_view message,
+                                     const send_scheduler::priority lane) {
+  m_connection->send_message(message, lane);
+}
 
-    std::pair<std::deque<std::string>, std::string> new_messages_raw{
-        split_messages(received_message)};
-    message_fragment = new_messages_raw.second;
+void vassal::irc::core::send_registration(const std::string &nick,
+                                          const std::string &realname,
+                                          const std::string &server_password) {
+  if (server_password != "") {
+    send_message_pass(server_password);
+  }
+  send_message_nick(nick);
+  send_message_user(nick, realname);
+}
 
-#ifdef DEBUG
-    {
-      for (size_t i{0}; i < new_messages_raw.first.size(); ++i) {
-        std::cout << color_codes::foreground_yellow
-                  << "[DEBUG]: [RECEIVED MESSAGE]: "
-                  << new_messages_raw.first[i] << color_codes::reset << '\n';
-      }
-    }
-#endif // DEBUG
+std::size_t
+vassal::irc::core::make_end_count_names(const std::string &channel) {
+  // one end-of-names reply comes back per listed channel
+  return (static_cast<std::size_t>(
+              std::count(channel.begin(), channel.end(), ',')) +
+          1);
+}
 
-    std::vector<size_t> messages_to_erase{};
-    for (size_t i{0}; i < new_messages_raw.first.size(); ++i) {
-      if (send_message_pong(new_messages_raw.first[i]) == true) {
-        messages_to_erase.push_back(i);
-      }
-    }
-    for (size_t i{0}; i < messages_to_erase.size(); ++i) {
-      new_messages_raw.first.erase(new_messages_raw.first.begin() +
-                                   messages_to_erase[i]);
-    }
+template <typename T, std::size_t N>
+std::string_view
+vassal::irc::core::make_flag(const std::array<char, N> &lut, const T value) {
+  return std::string_view{&lut[static_cast<std::size_t>(value)], 1};
+}
 
-    std::deque<message *> new_messages_parsed{};
-    new_messages_parsed.resize(new_messages_raw.first.size(), nullptr);
+vassal::irc::message_builder
+vassal::irc::core::make_message_names(const std::string &channel,
+                                      const std::string &target) {
+  message_builder message{"NAMES"};
 
-    for (size_t i{0}; i < new_messages_parsed.size(); ++i) {
-      switch (message::check_type(new_messages_raw.first[i])) {
-      case message::type::standard:
-        new_messages_parsed[i] =
-            new standard_message{new_messages_raw.first[i]};
-        break;
-      case message::type::numeric:
-        new_messages_parsed[i] = new numeric_message{new_messages_raw.first[i]};
-        break;
-      }
+  if (channel != "") {
+    message.add_param(channel);
+
+    if (target != "") {
+      message.add_param(target);
     }
+  }
 
-    {
-      std::unique_lock<std::mutex> m_unread_responses_mutex_lock{
-          m_unread_responses_mutex};
+  return message;
+}
 
-      m_unread_responses.insert(m_unread_responses.end(),
-                                new_messages_parsed.begin(),
-                                new_messages_parsed.end());
+vassal::irc::message_builder
+vassal::irc::core::make_message_list(const std::string &channel,
+                                     const std::string &target) {
+  message_builder message{"LIST"};
 
-      for (size_t i{0}; i < new_messages_parsed.size(); ++i) {
-        new_messages_parsed[i] = nullptr;
-      }
+  if (channel != "") {
+    message.add_param(channel);
 
-      m_new_unread_response = true;
+    if (target != "") {
+      message.add_param(target);
     }
-
-    m_unread_responses_cv.notify_all();
   }
+
+  return message;
 }
 
-void vassal::irc::core::send_message(const std::string &message) {
-  if (message.size() > m_k_max_message_length) {
-    throw std::runtime_error{"message is too long (" +
-                             std::to_string(message.size()) + " chars)"};
-  }
+vassal::irc::message_builder
+vassal::irc::core::make_message_stats(const stats_query query,
+                                      const std::string &target) {
+  message_builder message{"STATS"};
 
-  std::unique_lock<std::mutex> socket_mutex_write_lock{m_socket_mutex_write};
+  if (query != stats_query::N) {
+    message.add_param(make_flag(m_k_stats_query_lut, query));
 
-#ifdef DEBUG
-  {
-    std::unique_lock<std::mutex> output_mutex_lock{output_mutex::output_mutex};
-    std::cerr << color_codes::foreground_red
-              << "[DEBUG]: [SENDING MESSAGE]: " << message << color_codes::reset
-              << '\n';
+    if (target != "") {
+      message.add_param(target);
+    }
   }
-#endif // DEBUG
-  m_socket.send(std::string{message + m_k_delimiter});
+
+  return message;
 }
 
-std::pair<std::deque<std::string>, std::string>
-vassal::irc::core::split_messages(const std::string &messages_combined) {
-  std::string message_fragment{""};
+vassal::irc::message_builder
+vassal::irc::core::make_message_who(const std::string &mask,
+                                    const bool only_opers) {
+  message_builder message{"WHO"};
 
-  if (messages_combined.ends_with(m_k_delimiter) == false) {
-    message_fragment = messages_combined.substr(
-        (messages_combined.rfind(m_k_delimiter) + m_k_delimiter.size()),
-        std::string::npos);
+  if (mask != "") {
+    message.add_param(mask);
+
+    if (only_opers == true) {
+      message.add_param("o");
+    }
   }
 
-  std::deque<std::string> messages_split{};
-  std::string current_message{};
-  std::string::size_type pos_next{0};
-  std::string::size_type pos_last{0};
+  return message;
+}
+
+vassal::irc::message_builder
+vassal::irc::core::make_message_whois(const std::string &mask,
+                                      const std::string &target) {
+  message_builder message{"WHOIS"};
 
-  while ((pos_next = messages_combined.find(m_k_delimiter, pos_last)) !=
-         std::string::npos) {
-    messages_split.push_back(
-        messages_combined.substr(pos_last, (pos_next - pos_last)));
-    pos_last = pos_next + m_k_delimiter.size();
+  if (target != "") {
+    message.add_param(target);
   }
 
-  return {std::move(messages_split), std::move(message_fragment)};
+  message.add_param(mask);
+
+  return message;
 }
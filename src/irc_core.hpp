@@ -1,26 +1,41 @@
 #ifndef VASSAL_IRC_CORE_HPP
 #define VASSAL_IRC_CORE_HPP
 
+#include "irc_any_message.hpp"
+#include "irc_connection.hpp"
+#include "irc_coroutine.hpp"
+#include "irc_dispatcher.hpp"
+#include "irc_event_loop.hpp"
+#include "irc_inbound_queue.hpp"
+#include "irc_interest_filter.hpp"
 #include "irc_message.hpp"
+#include "irc_message_builder.hpp"
+#include "irc_message_slab.hpp"
+#include "irc_message_view.hpp"
 #include "irc_numeric_message.hpp"
+#include "irc_reply_tracker.hpp"
+#include "irc_send_scheduler.hpp"
 #include "irc_standard_message.hpp"
 
 #include "liblocket/liblocket.hpp"
 
 #include <array>
-#include <atomic>
-#include <condition_variable>
+#include <chrono>
 #include <cstddef>
-#include <deque>
-#include <mutex>
+#include <future>
+#include <memory>
+#include <span>
 #include <string>
-#include <thread>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 namespace vassal {
 
 namespace irc {
+// Movable handle to a connection. All connection state lives behind a
+// pointer, so a core can be moved (or stored in a std::vector) while its
+// listener thread or event loop keeps using the connection's fixed address.
 class core {
 public:
   enum class channel_mode {
@@ -73,25 +88,12 @@ public:
     N,
   };
 
-private:
-  liblocket::inet_socket_addr *m_server_address;
-  std::string m_nick;
-
-  liblocket::client_stream_socket m_socket;
-  std::mutex m_socket_mutex_write;
-
-  std::deque<message *> m_unread_responses;
-  std::atomic<bool> m_new_unread_response;
-  std::mutex m_unread_responses_mutex;
-  std::condition_variable m_unread_responses_cv;
-
-  std::thread m_listener_thread;
-  std::atomic<bool> m_listener_thread_kill_yourself;
+  using memory_usage = connection::memory_usage;
 
 private:
-  static constexpr int m_k_max_message_length{510};
-  static constexpr std::string m_k_delimiter{"\r\n"};
+  std::unique_ptr<connection> m_connection;
 
+private:
   static constexpr std::array<char, static_cast<size_t>(channel_mode::N)>
       m_k_channel_mode_lut{'O', 'o', 'v', 'a', 'i', 'm', 'n', 'q', 'p',
                            's', 'r', 't', 'k', 'l', 'b', 'e', 'I'};
@@ -101,14 +103,26 @@ private:
       m_k_mode_operation_lut{'+', '-'};
   static constexpr std::array<char, static_cast<size_t>(stats_query::N)>
       m_k_stats_query_lut{'l', 'm', 'o', 'u'};
+  static constexpr std::chrono::milliseconds m_k_default_query_timeout{30000};
 
 public:
   core(const std::string &server_address, uint16_t port_num,
        const std::string &nick, const std::string &realname,
        liblocket::inet_socket_addr::ip_version ip_version =
            liblocket::inet_socket_addr::ip_version::ipv4,
-       const std::string &server_password = "");
-  core(core &&other) /*TODO: noexcept()*/;
+       const std::string &server_password = "",
+       const inbound_queue::config &queue_config = inbound_queue::config{},
+       dispatcher *const message_dispatcher = nullptr,
+       const send_scheduler::config &send_config = send_scheduler::config{});
+  core(event_loop &loop, const std::string &server_address, uint16_t port_num,
+       const std::string &nick, const std::string &realname,
+       liblocket::inet_socket_addr::ip_version ip_version =
+           liblocket::inet_socket_addr::ip_version::ipv4,
+       const std::string &server_password = "",
+       const inbound_queue::config &queue_config = inbound_queue::config{},
+       dispatcher *const message_dispatcher = nullptr,
+       const send_scheduler::config &send_config = send_scheduler::config{});
+  core(core &&other) noexcept;
 
   core(const core &other) = delete;
 
@@ -116,6 +130,25 @@ public:
 
 public:
   message *recv_response();
+  message_view recv_response_view();
+  any_message recv_response_value();
+  std::size_t
+  recv_responses(const std::span<message_view> responses,
+                 const std::chrono::milliseconds timeout =
+                     std::chrono::milliseconds::max());
+  std::size_t
+  recv_responses(std::vector<message_view> &responses,
+                 const std::size_t max_count,
+                 const std::chrono::milliseconds timeout =
+                     std::chrono::milliseconds::max());
+  bool try_recv_response(message_view &response);
+
+  memory_usage get_memory_usage() const;
+
+  void set_interest_filter(const interest_filter &filter);
+  interest_filter get_interest_filter() const;
+  std::size_t get_filtered_line_count() const;
+  inbound_queue::counters get_queue_counters() const;
 
   void send_message_pass(const std::string &password);
   void send_message_nick(const std::string &nickname);
@@ -168,8 +201,12 @@ public:
 
   void send_message_privmsg(const std::string &receiver,
                             const std::string &text_to_be_sent);
+  void send_message_privmsg(const std::vector<std::string> &receivers,
+                            const std::string &text_to_be_sent);
   void send_message_notice(const std::string &receiver,
                            const std::string &text);
+  void send_message_notice(const std::vector<std::string> &receivers,
+                           const std::string &text);
 
   void send_message_motd(const std::string &target = "");
   void send_message_lusers(const std::string &mask = "",
@@ -205,7 +242,7 @@ public:
 
   void send_message_kill(const std::string &nickname,
                          const std::string &comment);
-  bool send_message_pong(const std::string &possible_ping_message);
+  bool send_message_pong(const std::string_view possible_ping_message);
 
   void send_message_away(const std::string &text = "");
   void send_message_rehash();
@@ -221,18 +258,101 @@ public:
   void send_message_ison(const std::string &nickname);
   void send_message_ison(const std::vector<std::string> &nicknames);
 
+  std::future<reply_tracker::reply>
+  query_names(const std::string &channel = "", const std::string &target = "",
+              const std::chrono::milliseconds timeout =
+                  m_k_default_query_timeout);
+  std::future<reply_tracker::reply>
+  query_list(const std::string &channel = "", const std::string &target = "",
+             const std::chrono::milliseconds timeout =
+                 m_k_default_query_timeout);
+  std::future<reply_tracker::reply>
+  query_stats(const stats_query query, const std::string &target = "",
+              const std::chrono::milliseconds timeout =
+                  m_k_default_query_timeout);
+  std::future<reply_tracker::reply>
+  query_who(const std::string &mask = "", bool only_opers = false,
+            const std::chrono::milliseconds timeout =
+                m_k_default_query_timeout);
+  std::future<reply_tracker::reply>
+  query_whois(const std::string &mask, const std::string &target = "",
+              const std::chrono::milliseconds timeout =
+                  m_k_default_query_timeout);
+
+  std::future<reply_tracker::reply>
+  stream_names(const reply_tracker::row_callback &on_row,
+               const std::string &channel = "", const std::string &target = "",
+               const std::chrono::milliseconds timeout =
+                   m_k_default_query_timeout);
+  std::future<reply_tracker::reply>
+  stream_list(const reply_tracker::row_callback &on_row,
+              const std::string &channel = "", const std::string &target = "",
+              const std::chrono::milliseconds timeout =
+                  m_k_default_query_timeout);
+  std::future<reply_tracker::reply>
+  stream_who(const reply_tracker::row_callback &on_row,
+             const std::string &mask = "", bool only_opers = false,
+             const std::chrono::milliseconds timeout =
+                 m_k_default_query_timeout);
+
+  message_awaitable
+  next_message(const interest_filter &filter = interest_filter{},
+               const connection::message_predicate &predicate =
+                   connection::message_predicate{},
+               const std::chrono::milliseconds timeout =
+                   std::chrono::milliseconds::max());
+  reply_awaitable
+  await_names(const std::string &channel = "", const std::string &target = "",
+              const std::chrono::milliseconds timeout =
+                  m_k_default_query_timeout);
+  reply_awaitable
+  await_list(const std::string &channel = "", const std::string &target = "",
+             const std::chrono::milliseconds timeout =
+                 m_k_default_query_timeout);
+  reply_awaitable
+  await_stats(const stats_query query, const std::string &target = "",
+              const std::chrono::milliseconds timeout =
+                  m_k_default_query_timeout);
+  reply_awaitable
+  await_who(const std::string &mask = "", bool only_opers = false,
+            const std::chrono::milliseconds timeout =
+                m_k_default_query_timeout);
+  reply_awaitable
+  await_whois(const std::string &mask, const std::string &target = "",
+              const std::chrono::milliseconds timeout =
+                  m_k_default_query_timeout);
+  timer_awaitable sleep_for(const std::chrono::milliseconds duration);
+
 public:
-  core &operator=(core &&other) /*TODO: noexcept()*/;
+  core &operator=(core &&other) noexcept;
 
   core &operator=(const core &other) = delete;
 
 public:
-  void listen();
-  void send_message(const std::string &message);
+  void send_message(const std::string_view message);
+  void send_message(const std::string_view message,
+                    const send_scheduler::priority lane);
 
 private:
-  static std::pair<std::deque<std::string>, std::string>
-  split_messages(const std::string &message);
+  void send_registration(const std::string &nick, const std::string &realname,
+                         const std::string &server_password);
+
+  static std::size_t make_end_count_names(const std::string &channel);
+
+  template <typename T, std::size_t N>
+  static std::string_view make_flag(const std::array<char, N> &lut,
+                                    const T value);
+
+  static message_builder make_message_names(const std::string &channel,
+                                            const std::string &target);
+  static message_builder make_message_list(const std::string &channel,
+                                           const std::string &target);
+  static message_builder make_message_stats(const stats_query query,
+                                            const std::string &target);
+  static message_builder make_message_who(const std::string &mask,
+                                          const bool only_opers);
+  static message_builder make_message_whois(const std::string &mask,
+                                            const std::string &target);
 };
 } // namespace irc
 
@@ -0,0 +1,119 @@
+#include "irc_coroutine.hpp"
+
+#include "irc_connection.hpp"
+#include "irc_interest_filter.hpp"
+#include "irc_message_view.hpp"
+#include "irc_reply_tracker.hpp"
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace {
+std::chrono::steady_clock::time_point
+make_deadline(const std::chrono::milliseconds timeout) {
+  return ((timeout == std::chrono::milliseconds::max())
+              ? std::chrono::steady_clock::time_point::max()
+              : (std::chrono::steady_clock::now() + timeout));
+}
+} // namespace
+
+vassal::irc::task
+vassal::irc::task::promise_type::get_return_object() noexcept {
+  return task{};
+}
+
+std::suspend_never
+vassal::irc::task::promise_type::initial_suspend() noexcept {
+  return std::suspend_never{};
+}
+
+std::suspend_never vassal::irc::task::promise_type::final_suspend() noexcept {
+  return std::suspend_never{};
+}
+
+void vassal::irc::task::promise_type::return_void() noexcept {}
+
+void vassal::irc::task::promise_type::unhandled_exception() noexcept {
+  // nobody holds on to a task, so there is nowhere to rethrow to
+  std::terminate();
+}
+
+vassal::irc::message_awaitable::message_awaitable(
+    connection *const owner, const interest_filter &filter,
+    const connection::message_predicate &predicate,
+    const std::chrono::milliseconds timeout)
+    : m_connection{owner}, m_filter{filter}, m_predicate{predicate},
+      m_deadline{make_deadline(timeout)}, m_result{} {}
+
+vassal::irc::message_awaitable::~message_awaitable() {}
+
+bool vassal::irc::message_awaitable::await_ready() const noexcept {
+  return false;
+}
+
+bool vassal::irc::message_awaitable::await_suspend(
+    const std::coroutine_handle<> handle) {
+  // the coroutine may be resumed on another thread before this returns, so
+  // nothing here touches the awaitable once the waiter is added
+  return m_connection->add_waiter(handle, m_filter, m_predicate, &m_result,
+                                  m_deadline);
+}
+
+std::optional<vassal::irc::message_view>
+vassal::irc::message_awaitable::await_resume() {
+  return std::move(m_result);
+}
+
+vassal::irc::reply_awaitable::reply_awaitable(
+    connection *const owner, const reply_tracker::query_kind kind,
+    const std::string_view message, const std::size_t end_count,
+    const std::chrono::milliseconds timeout)
+    : m_connection{owner}, m_kind{kind}, m_message{message},
+      m_end_count{end_count}, m_timeout{timeout}, m_result{{}, false} {}
+
+vassal::irc::reply_awaitable::~reply_awaitable() {}
+
+bool vassal::irc::reply_awaitable::await_ready() const noexcept {
+  return false;
+}
+
+void vassal::irc::reply_awaitable::await_suspend(
+    const std::coroutine_handle<> handle) {
+  // if the query can't be sent, send_query() takes it back before throwing,
+  // so the callback never runs and the coroutine resumes with the exception
+  m_connection->send_query(
+      m_kind, m_message, m_end_count, m_timeout,
+      reply_tracker::callback{[this, handle](reply_tracker::reply &&result) {
+        m_result = std::move(result);
+        handle.resume();
+      }});
+}
+
+vassal::irc::reply_tracker::reply
+vassal::irc::reply_awaitable::await_resume() {
+  return std::move(m_result);
+}
+
+vassal::irc::timer_awaitable::timer_awaitable(
+    connection *const owner, const std::chrono::milliseconds duration)
+    : m_connection{owner}, m_deadline{make_deadline(duration)} {}
+
+vassal::irc::timer_awaitable::~timer_awaitable() {}
+
+bool vassal::irc::timer_awaitable::await_ready() const noexcept {
+  return (m_deadline <= std::chrono::steady_clock::now());
+}
+
+bool vassal::irc::timer_awaitable::await_suspend(
+    const std::coroutine_handle<> handle) {
+  return m_connection->add_waiter(handle, interest_filter{},
+                                  connection::message_predicate{}, nullptr,
+                                  m_deadline);
+}
+
+void vassal::irc::timer_awaitable::await_resume() const noexcept {}
@@ -0,0 +1,127 @@
+#ifndef VASSAL_IRC_COROUTINE_HPP
+#define VASSAL_IRC_COROUTINE_HPP
+
+#include "irc_connection.hpp"
+#include "irc_interest_filter.hpp"
+#include "irc_message_view.hpp"
+#include "irc_reply_tracker.hpp"
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <optional>
+#include <string>
+
+namespace vassal {
+
+namespace irc {
+// Coroutine support for core. A task runs eagerly on the thread that calls
+// it until its first co_await, and from then on on whichever thread resumes
+// it: the connection's listener thread or its event loop. Tasks are fire and
+// forget; their frames free themselves when they finish, and an exception
+// escaping one terminates the program.
+class task {
+public:
+  class promise_type {
+  public:
+    task get_return_object() noexcept;
+    std::suspend_never initial_suspend() noexcept;
+    std::suspend_never final_suspend() noexcept;
+    void return_void() noexcept;
+    void unhandled_exception() noexcept;
+  };
+};
+
+// Resumes with the next message that passes the filter and the predicate,
+// or with std::nullopt on timeout or once the connection closes. A message
+// handed to a coroutine is neither dispatched nor queued. The predicate runs
+// with the connection's waiter list locked and must not call back into it.
+class message_awaitable {
+private:
+  connection *m_connection;
+  interest_filter m_filter;
+  connection::message_predicate m_predicate;
+  std::chrono::steady_clock::time_point m_deadline;
+  std::optional<message_view> m_result;
+
+public:
+  message_awaitable(connection *const owner, const interest_filter &filter,
+                    const connection::message_predicate &predicate,
+                    const std::chrono::milliseconds timeout);
+
+  message_awaitable(const message_awaitable &other) = delete;
+  message_awaitable(message_awaitable &&other) = delete;
+
+  ~message_awaitable();
+
+public:
+  bool await_ready() const noexcept;
+  bool await_suspend(const std::coroutine_handle<> handle);
+  std::optional<message_view> await_resume();
+
+public:
+  message_awaitable &operator=(const message_awaitable &other) = delete;
+  message_awaitable &operator=(message_awaitable &&other) = delete;
+};
+
+// Sends a query and resumes with its reply once the tracker has collected
+// it; the reply is incomplete if the query timed out or the connection
+// closed.
+class reply_awaitable {
+private:
+  connection *m_connection;
+  reply_tracker::query_kind m_kind;
+  std::string m_message;
+  std::size_t m_end_count;
+  std::chrono::milliseconds m_timeout;
+  reply_tracker::reply m_result;
+
+public:
+  reply_awaitable(connection *const owner,
+                  const reply_tracker::query_kind kind,
+                  const std::string_view message, const std::size_t end_count,
+                  const std::chrono::milliseconds timeout);
+
+  reply_awaitable(const reply_awaitable &other) = delete;
+  reply_awaitable(reply_awaitable &&other) = delete;
+
+  ~reply_awaitable();
+
+public:
+  bool await_ready() const noexcept;
+  void await_suspend(const std::coroutine_handle<> handle);
+  reply_tracker::reply await_resume();
+
+public:
+  reply_awaitable &operator=(const reply_awaitable &other) = delete;
+  reply_awaitable &operator=(reply_awaitable &&other) = delete;
+};
+
+// Resumes once the duration has passed, or early if the connection closes.
+class timer_awaitable {
+private:
+  connection *m_connection;
+  std::chrono::steady_clock::time_point m_deadline;
+
+public:
+  timer_awaitable(connection *const owner,
+                  const std::chrono::milliseconds duration);
+
+  timer_awaitable(const timer_awaitable &other) = delete;
+  timer_awaitable(timer_awaitable &&other) = delete;
+
+  ~timer_awaitable();
+
+public:
+  bool await_ready() const noexcept;
+  bool await_suspend(const std::coroutine_handle<> handle);
+  void await_resume() const noexcept;
+
+public:
+  timer_awaitable &operator=(const timer_awaitable &other) = delete;
+  timer_awaitable &operator=(timer_awaitable &&other) = delete;
+};
+} // namespace irc
+
+} // namespace vassal
+#endif
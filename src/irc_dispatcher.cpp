@@ -0,0 +1,113 @@
+#include "irc_dispatcher.hpp"
+
+#include "irc_commands.hpp"
+#include "irc_message.hpp"
+#include "irc_message_view.hpp"
+#include "irc_numeric_codes.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+vassal::irc::dispatcher::dispatcher()
+    : m_command_handlers{}, m_numeric_handlers{}, m_wildcard_handlers{},
+      m_handlers_mutex{} {}
+
+vassal::irc::dispatcher::~dispatcher() {}
+
+void vassal::irc::dispatcher::add_handler(const irc::command command,
+                                          handler callback) {
+  if (command >= irc::command::N) {
+    throw std::runtime_error{"invalid command"};
+  }
+
+  std::unique_lock<std::shared_mutex> handlers_lock{m_handlers_mutex};
+  append(m_command_handlers[static_cast<std::size_t>(command)],
+         std::move(callback));
+}
+
+void vassal::irc::dispatcher::add_handler(const int numeric_code,
+                                          handler callback) {
+  if ((numeric_code < 0) || (numeric_code >= numeric_codes::k_code_count)) {
+    throw std::runtime_error{"invalid numeric code " +
+                             std::to_string(numeric_code)};
+  }
+
+  std::unique_lock<std::shared_mutex> handlers_lock{m_handlers_mutex};
+  append(m_numeric_handlers[static_cast<std::size_t>(numeric_code)],
+         std::move(callback));
+}
+
+void vassal::irc::dispatcher::add_wildcard_handler(handler callback) {
+  std::unique_lock<std::shared_mutex> handlers_lock{m_handlers_mutex};
+  append(m_wildcard_handlers, std::move(callback));
+}
+
+void vassal::irc::dispatcher::clear() {
+  std::unique_lock<std::shared_mutex> handlers_lock{m_handlers_mutex};
+
+  for (size_t i{0}; i < m_command_handlers.size(); ++i) {
+    m_command_handlers[i].reset();
+  }
+  for (size_t i{0}; i < m_numeric_handlers.size(); ++i) {
+    m_numeric_handlers[i].reset();
+  }
+  m_wildcard_handlers.reset();
+}
+
+bool vassal::irc::dispatcher::dispatch(const message_view &message) const {
+  handler_list handlers{};
+  handler_list wildcard_handlers{};
+
+  {
+    std::shared_lock<std::shared_mutex> handlers_lock{m_handlers_mutex};
+
+    if (message.get_type() == message::type::numeric) {
+      const int numeric_code{
+          numeric_codes::parse_code(message.get_keyword())};
+      if (numeric_code != -1) {
+        handlers = m_numeric_handlers[static_cast<std::size_t>(numeric_code)];
+      }
+    } else {
+      handlers =
+          m_command_handlers[static_cast<std::size_t>(message.get_command())];
+    }
+
+    wildcard_handlers = m_wildcard_handlers;
+  }
+
+  bool dispatched{false};
+
+  if (handlers != nullptr) {
+    for (size_t i{0}; i < handlers->size(); ++i) {
+      (*handlers)[i](message);
+      dispatched = true;
+    }
+  }
+
+  if (wildcard_handlers != nullptr) {
+    for (size_t i{0}; i < wildcard_handlers->size(); ++i) {
+      (*wildcard_handlers)[i](message);
+      dispatched = true;
+    }
+  }
+
+  return dispatched;
+}
+
+void vassal::irc::dispatcher::append(handler_list &handlers,
+                                     handler &&callback) {
+  // a dispatch running on another thread (or further up this one) may still
+  // be walking the old list, so it is copied rather than changed
+  std::shared_ptr<std::vector<handler>> updated{
+      (handlers != nullptr) ? std::make_shared<std::vector<handler>>(*handlers)
+                            : std::make_shared<std::vector<handler>>()};
+  updated->push_back(std::move(callback));
+
+  handlers = std::move(updated);
+}
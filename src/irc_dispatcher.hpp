@@ -0,0 +1,72 @@
+#ifndef VASSAL_IRC_DISPATCHER_HPP
+#define VASSAL_IRC_DISPATCHER_HPP
+
+#include "irc_commands.hpp"
+#include "irc_message_view.hpp"
+#include "irc_numeric_codes.hpp"
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+namespace vassal {
+
+namespace irc {
+// Routes incoming messages to callbacks registered per command, per numeric
+// code, or for every message. Lookups index flat tables by command id and
+// numeric code, so dispatching never compares keyword strings. A connection
+// given a dispatcher calls it from its listener thread (or event loop)
+// before queueing; messages that reach at least one handler are not queued.
+//
+// Each handler list is replaced rather than changed in place, so dispatch()
+// only holds the lock long enough to take the current lists and runs the
+// handlers after releasing it. A handler may therefore register handlers or
+// clear the dispatcher; the change applies from the next message on.
+class dispatcher {
+public:
+  using handler = std::function<void(const message_view &message)>;
+
+private:
+  using handler_list = std::shared_ptr<const std::vector<handler>>;
+
+private:
+  std::array<handler_list, static_cast<std::size_t>(command::N)>
+      m_command_handlers;
+  std::array<handler_list,
+             static_cast<std::size_t>(numeric_codes::k_code_count)>
+      m_numeric_handlers;
+  handler_list m_wildcard_handlers;
+
+  mutable std::shared_mutex m_handlers_mutex;
+
+public:
+  dispatcher();
+
+  dispatcher(const dispatcher &other) = delete;
+  dispatcher(dispatcher &&other) = delete;
+
+  ~dispatcher();
+
+public:
+  void add_handler(const irc::command command, handler callback);
+  void add_handler(const int numeric_code, handler callback);
+  void add_wildcard_handler(handler callback);
+
+  void clear();
+
+  bool dispatch(const message_view &message) const;
+
+public:
+  dispatcher &operator=(const dispatcher &other) = delete;
+  dispatcher &operator=(dispatcher &&other) = delete;
+
+private:
+  static void append(handler_list &handlers, handler &&callback);
+};
+} // namespace irc
+
+} // namespace vassal
+#endif
@@ -0,0 +1,70 @@
+#include "irc_event_count.hpp"
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+vassal::irc::event_count::event_count() : m_epoch{0}, m_waiters{0} {}
+
+vassal::irc::event_count::~event_count() {}
+
+std::uint32_t vassal::irc::event_count::prepare_wait() {
+  m_waiters.fetch_add(1, std::memory_order_seq_cst);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  return m_epoch.load(std::memory_order_seq_cst);
+}
+
+void vassal::irc::event_count::cancel_wait() {
+  m_waiters.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+void vassal::irc::event_count::wait(const std::uint32_t epoch) {
+  while (m_epoch.load(std::memory_order_seq_cst) == epoch) {
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&m_epoch),
+              FUTEX_WAIT_PRIVATE, epoch, nullptr, nullptr, 0);
+  }
+
+  m_waiters.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+bool vassal::irc::event_count::wait_until(
+    const std::uint32_t epoch,
+    const std::chrono::steady_clock::time_point deadline) {
+  while (m_epoch.load(std::memory_order_seq_cst) == epoch) {
+    const std::chrono::steady_clock::duration remaining{
+        deadline - std::chrono::steady_clock::now()};
+    if (remaining <= std::chrono::steady_clock::duration::zero()) {
+      m_waiters.fetch_sub(1, std::memory_order_seq_cst);
+      return false;
+    }
+
+    const std::chrono::seconds remaining_seconds{
+        std::chrono::duration_cast<std::chrono::seconds>(remaining)};
+    const timespec timeout{
+        static_cast<time_t>(remaining_seconds.count()),
+        static_cast<long>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              remaining - remaining_seconds)
+                              .count())};
+
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&m_epoch),
+              FUTEX_WAIT_PRIVATE, epoch, &timeout, nullptr, 0);
+  }
+
+  m_waiters.fetch_sub(1, std::memory_order_seq_cst);
+  return true;
+}
+
+void vassal::irc::event_count::notify() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  if (m_waiters.load(std::memory_order_seq_cst) != 0) {
+    m_epoch.fetch_add(1, std::memory_order_seq_cst);
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&m_epoch),
+              FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+  }
+}
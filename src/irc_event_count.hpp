@@ -0,0 +1,43 @@
+#ifndef VASSAL_IRC_EVENT_COUNT_HPP
+#define VASSAL_IRC_EVENT_COUNT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace vassal {
+
+namespace irc {
+// Lets a lock-free consumer sleep on a futex until a producer makes progress.
+// Waiters announce themselves with prepare_wait(), re-check their condition
+// and only then wait(); notify() costs a single load while nobody is asleep.
+class event_count {
+private:
+  std::atomic<std::uint32_t> m_epoch;
+  std::atomic<std::uint32_t> m_waiters;
+
+public:
+  event_count();
+
+  event_count(const event_count &other) = delete;
+  event_count(event_count &&other) = delete;
+
+  ~event_count();
+
+public:
+  std::uint32_t prepare_wait();
+  void cancel_wait();
+  void wait(const std::uint32_t epoch);
+  bool wait_until(const std::uint32_t epoch,
+                  const std::chrono::steady_clock::time_point deadline);
+
+  void notify();
+
+public:
+  event_count &operator=(const event_count &other) = delete;
+  event_count &operator=(event_count &&other) = delete;
+};
+} // namespace irc
+
+} // namespace vassal
+#endif
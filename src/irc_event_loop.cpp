@@ -0,0 +1,768 @@
+#include "irc_event_loop.hpp"
+
+#include "irc_io_uring.hpp"
+
+#include <linux/io_uring.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace {
+// io_uring user_data layout: the low two bits tell completions apart, receive
+// completions carry the fd and registration generation, send completions
+// carry the (suitably aligned) request pointer, wakeup completions carry
+// which of the eventfd and the timerfd was read
+constexpr std::uint64_t k_tag_mask{0b11};
+constexpr std::uint64_t k_tag_send{0b00};
+constexpr std::uint64_t k_tag_receive{0b01};
+constexpr std::uint64_t k_tag_wakeup{0b10};
+constexpr std::uint64_t k_tag_ignore{0b11};
+constexpr std::uint64_t k_wakeup_source_timer{0b100};
+
+constexpr std::uint64_t make_receive_user_data(const int fd,
+                                               const std::uint32_t generation) {
+  return ((static_cast<std::uint64_t>(generation) << 32) |
+          (static_cast<std::uint64_t>(static_cast<std::uint32_t>(fd)) << 2) |
+          k_tag_receive);
+}
+} // namespace
+
+vassal::irc::event_loop::event_loop(
+    const backend preferred_backend /*= backend::epoll*/)
+    : m_backend{backend::epoll}, m_epoll_fd{-1}, m_wakeup_fd{-1},
+      m_timer_fd{-1}, m_io_uring{}, m_wakeup_value{0}, m_timer_value{0},
+      m_handlers{}, m_next_generation{0}, m_timers{}, m_pending_operations{},
+      m_sends_in_flight{}, m_send_ready_fds{}, m_sends_done{},
+      m_sends_done_waiter_count{0}, m_thread{}, m_running_thread_id{},
+      m_stop{false} {
+  if (preferred_backend == backend::io_uring) {
+    try {
+      m_io_uring.reset(new io_uring_context{m_k_io_uring_entries});
+      m_io_uring->register_buffer_ring(m_k_io_uring_buffer_group,
+                                       m_k_io_uring_buffer_count,
+                                       m_k_io_uring_buffer_size);
+      m_backend = backend::io_uring;
+    } catch (const std::runtime_error &) {
+      // kernel too old or io_uring disabled, use epoll instead
+      m_io_uring.reset();
+    }
+  }
+
+  if (m_backend == backend::io_uring) {
+    // io_uring reads from these, so they stay blocking
+    m_wakeup_fd = ::eventfd(0, EFD_CLOEXEC);
+    m_timer_fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+
+    if ((m_wakeup_fd == -1) || (m_timer_fd == -1)) {
+      const int error{errno};
+
+      if (m_wakeup_fd != -1) {
+        ::close(m_wakeup_fd);
+      }
+      if (m_timer_fd != -1) {
+        ::close(m_timer_fd);
+      }
+
+      throw std::runtime_error{
+          std::string{"failed to create event loop ("} +
+          std::strerror(error) + ")"};
+    }
+
+    return;
+  }
+
+  m_epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+  m_wakeup_fd = ::eventfd(0, (EFD_CLOEXEC | EFD_NONBLOCK));
+  m_timer_fd = ::timerfd_create(CLOCK_MONOTONIC, (TFD_CLOEXEC | TFD_NONBLOCK));
+
+  if ((m_epoll_fd == -1) || (m_wakeup_fd == -1) || (m_timer_fd == -1)) {
+    const int error{errno};
+
+    if (m_epoll_fd != -1) {
+      ::close(m_epoll_fd);
+    }
+    if (m_wakeup_fd != -1) {
+      ::close(m_wakeup_fd);
+    }
+    if (m_timer_fd != -1) {
+      ::close(m_timer_fd);
+    }
+
+    throw std::runtime_error{std::string{"failed to create event loop ("} +
+                             std::strerror(error) + ")"};
+  }
+
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.fd = m_wakeup_fd;
+  ::epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_wakeup_fd, &event);
+  event.data.fd = m_timer_fd;
+  ::epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_timer_fd, &event);
+}
+
+vassal::irc::event_loop::~event_loop() {
+  stop();
+
+  if (m_thread.joinable() == true) {
+    m_thread.join();
+  }
+
+  // tearing the ring down first guarantees the kernel is done with any send
+  // buffers still in flight
+  m_io_uring.reset();
+
+  for (send_request *request : m_sends_in_flight) {
+    delete request;
+  }
+  for (std::pair<const int, registration> &handler : m_handlers) {
+    for (send_request *request : handler.second.queued_sends) {
+      delete request;
+    }
+  }
+
+  ::close(m_wakeup_fd);
+  ::close(m_timer_fd);
+  if (m_epoll_fd != -1) {
+    ::close(m_epoll_fd);
+  }
+}
+
+void vassal::irc::event_loop::add(const int fd, handler *handler) {
+  std::unique_lock<std::recursive_mutex> handlers_mutex_lock{m_handlers_mutex};
+
+  if (m_handlers.contains(fd) == true) {
+    throw std::runtime_error{"fd is already registered with event loop"};
+  }
+
+  const std::uint32_t generation{m_next_generation++};
+
+  if (m_backend == backend::epoll) {
+    epoll_event event{};
+    event.events = (EPOLLIN | EPOLLRDHUP);
+    event.data.fd = fd;
+
+    if (::epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event) == -1) {
+      throw std::runtime_error{
+          std::string{"failed to add fd to event loop ("} +
+          std::strerror(errno) + ")"};
+    }
+  } else {
+    post(pending_operation{operation_kind::arm_receive, fd, generation});
+  }
+
+  m_handlers.emplace(
+      fd, registration{handler, generation, {}, 0,
+                       std::chrono::steady_clock::time_point::max(), false,
+                       false, false, false});
+}
+
+void vassal::irc::event_loop::update(const int fd, handler *handler) {
+  std::unique_lock<std::recursive_mutex> handlers_mutex_lock{m_handlers_mutex};
+
+  std::unordered_map<int, registration>::iterator it{m_handlers.find(fd)};
+  if (it == m_handlers.end()) {
+    throw std::runtime_error{"fd is not registered with event loop"};
+  }
+
+  it->second.target = handler;
+}
+
+bool vassal::irc::event_loop::remove(
+    const int fd,
+    const std::chrono::steady_clock::time_point
+        send_deadline /*= std::chrono::steady_clock::time_point::min()*/) {
+  std::unique_lock<std::recursive_mutex> handlers_mutex_lock{m_handlers_mutex};
+
+  std::unordered_map<int, registration>::iterator it{m_handlers.find(fd)};
+  if (it == m_handlers.end()) {
+    return true;
+  }
+
+  // the loop thread can't finish any sends while it waits here itself
+  const std::thread::id running_thread_id{m_running_thread_id};
+  if ((m_backend == backend::io_uring) &&
+      (running_thread_id != std::thread::id{}) &&
+      (running_thread_id != std::this_thread::get_id())) {
+    ++m_sends_done_waiter_count;
+    m_sends_done.wait_until(
+        handlers_mutex_lock, send_deadline,
+        [this, fd]() -> bool { return are_sends_done(fd); });
+    --m_sends_done_waiter_count;
+
+    // a hangup may have removed it in the meantime
+    it = m_handlers.find(fd);
+    if (it == m_handlers.end()) {
+      return true;
+    }
+  }
+
+  const bool is_sending{it->second.sends_in_flight != 0};
+
+  if (it->second.timer_deadline !=
+      std::chrono::steady_clock::time_point::max()) {
+    m_timers.erase(std::make_pair(it->second.timer_deadline, fd));
+  }
+
+  if (m_backend == backend::epoll) {
+    ::epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+  } else {
+    for (send_request *request : it->second.queued_sends) {
+      delete request;
+    }
+    post(pending_operation{operation_kind::cancel_receive, fd,
+                           it->second.generation});
+  }
+
+  m_handlers.erase(it);
+
+  return (is_sending == false);
+}
+
+void vassal::irc::event_loop::send(const int fd, std::string &&data) {
+  if (m_backend != backend::io_uring) {
+    throw std::runtime_error{"event loop send requires the io_uring backend"};
+  }
+
+  std::unique_lock<std::recursive_mutex> handlers_mutex_lock{m_handlers_mutex};
+
+  std::unordered_map<int, registration>::iterator it{m_handlers.find(fd)};
+  if (it == m_handlers.end()) {
+    return;
+  }
+
+  // queued straight onto the registration, so remove() sees it
+  it->second.queued_sends.push_back(
+      new send_request{fd, it->second.generation, std::move(data)});
+  m_send_ready_fds.push_back(fd);
+
+  if (m_running_thread_id != std::this_thread::get_id()) {
+    wake_up();
+  }
+}
+
+void vassal::irc::event_loop::request_write(const int fd) {
+  std::unique_lock<std::recursive_mutex> handlers_mutex_lock{m_handlers_mutex};
+
+  std::unordered_map<int, registration>::iterator it{m_handlers.find(fd)};
+  if (it == m_handlers.end()) {
+    return;
+  }
+
+  if (m_backend == backend::epoll) {
+    it->second.is_write_watched = true;
+
+    if (watch_epoll_events(fd, it->second) == -1) {
+      throw std::runtime_error{
+          std::string{"failed to watch fd for writability ("} +
+          std::strerror(errno) + ")"};
+    }
+  } else {
+    post(pending_operation{operation_kind::notify_writable, fd,
+                           it->second.generation});
+  }
+}
+
+void vassal::irc::event_loop::pause_reading(const int fd) {
+  std::unique_lock<std::recursive_mutex> handlers_mutex_lock{m_handlers_mutex};
+
+  std::unordered_map<int, registration>::iterator it{m_handlers.find(fd)};
+  if ((it == m_handlers.end()) || (it->second.is_reading_paused == true)) {
+    return;
+  }
+
+  it->second.is_reading_paused = true;
+
+  if (m_backend == backend::epoll) {
+    watch_epoll_events(fd, it->second);
+  } else {
+    post(pending_operation{operation_kind::cancel_receive, fd,
+                           it->second.generation});
+  }
+}
+
+void vassal::irc::event_loop::resume_reading(const int fd) {
+  std::unique_lock<std::recursive_mutex> handlers_mutex_lock{m_handlers_mutex};
+
+  std::unordered_map<int, registration>::iterator it{m_handlers.find(fd)};
+  if ((it == m_handlers.end()) || (it->second.is_reading_paused == false)) {
+    return;
+  }
+
+  it->second.is_reading_paused = false;
+
+  if (m_backend == backend::epoll) {
+    watch_epoll_events(fd, it->second);
+  }
+
+  // the handler may be holding input back that it couldn't pass on, and
+  // nothing new has to arrive for it to get another go
+  post(pending_operation{operation_kind::resume_receive, fd,
+                         it->second.generation});
+}
+
+void vassal::irc::event_loop::set_timer(
+    const int fd, const std::chrono::steady_clock::time_point deadline) {
+  std::unique_lock<std::recursive_mutex> handlers_mutex_lock{m_handlers_mutex};
+
+  // a handler that hung up may still be tidying its timer away
+  std::unordered_map<int, registration>::iterator it{m_handlers.find(fd)};
+  if (it == m_handlers.end()) {
+    return;
+  }
+
+  if (it->second.timer_deadline == deadline) {
+    return;
+  }
+
+  if (it->second.timer_deadline !=
+      std::chrono::steady_clock::time_point::max()) {
+    m_timers.erase(std::make_pair(it->second.timer_deadline, fd));
+  }
+  it->second.timer_deadline = deadline;
+  if (deadline != std::chrono::steady_clock::time_point::max()) {
+    m_timers.emplace(deadline, fd);
+  }
+
+  arm_timer();
+}
+
+void vassal::irc::event_loop::run() {
+  m_running_thread_id = std::this_thread::get_id();
+
+  if (m_backend == backend::io_uring) {
+    run_io_uring();
+  } else {
+    run_epoll();
+  }
+
+  m_running_thread_id = std::thread::id{};
+}
+
+void vassal::irc::event_loop::start() {
+  if (m_thread.joinable() == true) {
+    throw std::runtime_error{"event loop is already running"};
+  }
+
+  m_stop = false;
+  m_thread = std::thread{&event_loop::run, this};
+}
+
+void vassal::irc::event_loop::stop() {
+  m_stop = true;
+  wake_up();
+}
+
+vassal::irc::event_loop::backend vassal::irc::event_loop::get_backend() const {
+  return m_backend;
+}
+
+std::size_t vassal::irc::event_loop::get_handler_count() {
+  std::unique_lock<std::recursive_mutex> handlers_mutex_lock{m_handlers_mutex};
+  return m_handlers.size();
+}
+
+void vassal::irc::event_loop::run_epoll() {
+  std::array<epoll_event, m_k_max_events> events{};
+
+  while (m_stop == false) {
+    const int event_count{
+        ::epoll_wait(m_epoll_fd, events.data(), m_k_max_events, -1)};
+
+    if (event_count == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error{std::string{"epoll_wait() failed ("} +
+                               std::strerror(errno) + ")"};
+    }
+
+    std::unique_lock<std::recursive_mutex> handlers_mutex_lock{
+        m_handlers_mutex};
+
+    for (int i{0}; i < event_count; ++i) {
+      const int fd{events[i].data.fd};
+
+      if ((fd == m_wakeup_fd) || (fd == m_timer_fd)) {
+        std::uint64_t value{0};
+        while (::read(fd, &value, sizeof(value)) > 0) {
+        }
+        if (fd == m_wakeup_fd) {
+          submit_pending_operations();
+        }
+        continue;
+      }
+
+      // the handler may have been removed earlier in this batch
+      std::unordered_map<int, registration>::iterator it{m_handlers.find(fd)};
+      if (it == m_handlers.end()) {
+        continue;
+      }
+
+      if (((events[i].events & EPOLLIN) != 0) &&
+          (it->second.is_reading_paused == false)) {
+        it->second.target->handle_readable();
+        it = m_handlers.find(fd);
+      }
+
+      // writability is only watched until the handler has been told, since
+      // a level-triggered EPOLLOUT would otherwise fire on every wait
+      if ((it != m_handlers.end()) && ((events[i].events & EPOLLOUT) != 0)) {
+        it->second.is_write_watched = false;
+        watch_epoll_events(fd, it->second);
+
+        it->second.target->handle_writable();
+        it = m_handlers.find(fd);
+      }
+
+      if ((it != m_handlers.end()) &&
+          ((events[i].events & (EPOLLHUP | EPOLLERR)) != 0)) {
+        it->second.target->handle_hangup();
+      }
+    }
+
+    run_timers();
+  }
+}
+
+void vassal::irc::event_loop::run_io_uring() {
+  submit_wakeup_read();
+  submit_timer_read();
+
+  while (m_stop == false) {
+    {
+      std::unique_lock<std::recursive_mutex> handlers_mutex_lock{
+          m_handlers_mutex};
+      submit_pending_operations();
+    }
+
+    m_io_uring->submit(1);
+
+    std::unique_lock<std::recursive_mutex> handlers_mutex_lock{
+        m_handlers_mutex};
+
+    while (const io_uring_cqe *cqe{m_io_uring->peek_cqe()}) {
+      const io_uring_cqe completion{*cqe};
+      m_io_uring->consume_cqe();
+      handle_completion(completion);
+    }
+
+    run_timers();
+
+    for (const int fd : m_send_ready_fds) {
+      submit_queued_sends(fd);
+    }
+    m_send_ready_fds.clear();
+
+    if (m_sends_done_waiter_count != 0) {
+      m_sends_done.notify_all();
+    }
+  }
+}
+
+int vassal::irc::event_loop::watch_epoll_events(const int fd,
+                                               const registration &watched) {
+  // a paused socket isn't watched for input at all, or a level-triggered
+  // EPOLLIN (or EPOLLRDHUP) would wake the loop on every wait
+  epoll_event event{};
+  event.events = (((watched.is_reading_paused == false)
+                       ? static_cast<std::uint32_t>(EPOLLIN | EPOLLRDHUP)
+                       : 0) |
+                  ((watched.is_write_watched == true)
+                       ? static_cast<std::uint32_t>(EPOLLOUT)
+                       : 0));
+  event.data.fd = fd;
+
+  return ::epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, fd, &event);
+}
+
+void vassal::irc::event_loop::post(const pending_operation &operation) {
+  {
+    std::unique_lock<std::mutex> pending_operations_mutex_lock{
+        m_pending_operations_mutex};
+    m_pending_operations.push_back(operation);
+  }
+
+  wake_up();
+}
+
+void vassal::irc::event_loop::submit_pending_operations() {
+  std::vector<pending_operation> operations{};
+  {
+    std::unique_lock<std::mutex> pending_operations_mutex_lock{
+        m_pending_operations_mutex};
+    operations.swap(m_pending_operations);
+  }
+
+  for (const pending_operation &operation : operations) {
+    std::unordered_map<int, registration>::iterator it{
+        m_handlers.find(operation.fd)};
+
+    switch (operation.kind) {
+    case operation_kind::arm_receive:
+      if ((it != m_handlers.end()) &&
+          (it->second.generation == operation.generation)) {
+        submit_receive(operation.fd, operation.generation);
+      }
+      break;
+    case operation_kind::cancel_receive: {
+      io_uring_sqe *sqe{m_io_uring->get_sqe()};
+      sqe->opcode = IORING_OP_ASYNC_CANCEL;
+      sqe->fd = -1;
+      sqe->addr = make_receive_user_data(operation.fd, operation.generation);
+      sqe->user_data = k_tag_ignore;
+    } break;
+    case operation_kind::notify_writable:
+      if ((it != m_handlers.end()) &&
+          (it->second.generation == operation.generation)) {
+        // lines are only handed over once the last ones are out, so until
+        // then the handler can still let urgent ones overtake them
+        if ((m_backend == backend::io_uring) &&
+            (it->second.sends_in_flight != 0)) {
+          it->second.is_write_pending = true;
+        } else {
+          it->second.target->handle_writable();
+        }
+      }
+      break;
+    case operation_kind::resume_receive:
+      if ((it != m_handlers.end()) &&
+          (it->second.generation == operation.generation)) {
+        if ((m_backend == backend::io_uring) &&
+            (it->second.is_reading_paused == false) &&
+            (it->second.is_receive_armed == false)) {
+          submit_receive(operation.fd, operation.generation);
+        }
+        it->second.target->handle_resumed();
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  for (const int fd : m_send_ready_fds) {
+    submit_queued_sends(fd);
+  }
+  m_send_ready_fds.clear();
+}
+
+bool vassal::irc::event_loop::are_sends_done(const int fd) {
+  std::unordered_map<int, registration>::iterator it{m_handlers.find(fd)};
+
+  return ((it == m_handlers.end()) ||
+          ((it->second.sends_in_flight == 0) &&
+           (it->second.queued_sends.empty() == true)));
+}
+
+void vassal::irc::event_loop::submit_receive(const int fd,
+                                             const std::uint32_t generation) {
+  std::unordered_map<int, registration>::iterator it{m_handlers.find(fd)};
+  if (it != m_handlers.end()) {
+    it->second.is_receive_armed = true;
+  }
+
+  io_uring_sqe *sqe{m_io_uring->get_sqe()};
+  sqe->opcode = IORING_OP_RECV;
+  sqe->fd = fd;
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = m_io_uring->get_buffer_group();
+  sqe->user_data = make_receive_user_data(fd, generation);
+}
+
+void vassal::irc::event_loop::submit_queued_sends(const int fd) {
+  std::unordered_map<int, registration>::iterator it{m_handlers.find(fd)};
+  if ((it == m_handlers.end()) || (it->second.sends_in_flight != 0) ||
+      (it->second.queued_sends.empty() == true)) {
+    return;
+  }
+
+  // one linked chain per connection at a time keeps its sends in order
+  std::deque<send_request *> &queued_sends{it->second.queued_sends};
+  while (queued_sends.empty() == false) {
+    send_request *request{queued_sends.front()};
+    queued_sends.pop_front();
+
+    io_uring_sqe *sqe{m_io_uring->get_sqe()};
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<std::uint64_t>(request->data.data());
+    sqe->len = static_cast<std::uint32_t>(request->data.size());
+    sqe->msg_flags = (MSG_NOSIGNAL | MSG_WAITALL);
+    sqe->flags = ((queued_sends.empty() == false) ? IOSQE_IO_LINK : 0);
+    sqe->user_data = (reinterpret_cast<std::uint64_t>(request) | k_tag_send);
+
+    m_sends_in_flight.insert(request);
+    ++it->second.sends_in_flight;
+  }
+}
+
+void vassal::irc::event_loop::submit_wakeup_read() {
+  io_uring_sqe *sqe{m_io_uring->get_sqe()};
+  sqe->opcode = IORING_OP_READ;
+  sqe->fd = m_wakeup_fd;
+  sqe->addr = reinterpret_cast<std::uint64_t>(&m_wakeup_value);
+  sqe->len = sizeof(m_wakeup_value);
+  sqe->user_data = k_tag_wakeup;
+}
+
+void vassal::irc::event_loop::submit_timer_read() {
+  io_uring_sqe *sqe{m_io_uring->get_sqe()};
+  sqe->opcode = IORING_OP_READ;
+  sqe->fd = m_timer_fd;
+  sqe->addr = reinterpret_cast<std::uint64_t>(&m_timer_value);
+  sqe->len = sizeof(m_timer_value);
+  sqe->user_data = (k_wakeup_source_timer | k_tag_wakeup);
+}
+
+void vassal::irc::event_loop::handle_completion(const io_uring_cqe &cqe) {
+  switch (cqe.user_data & k_tag_mask) {
+  case k_tag_wakeup:
+    if ((cqe.user_data & k_wakeup_source_timer) != 0) {
+      submit_timer_read();
+    } else {
+      submit_wakeup_read();
+    }
+    break;
+
+  case k_tag_receive: {
+    const int fd{static_cast<int>((cqe.user_data >> 2) & 0x3fffffff)};
+    const std::uint32_t generation{
+        static_cast<std::uint32_t>(cqe.user_data >> 32)};
+    const bool has_buffer{(cqe.flags & IORING_CQE_F_BUFFER) != 0};
+    const std::uint16_t buffer_id{
+        static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT)};
+
+    std::unordered_map<int, registration>::iterator it{m_handlers.find(fd)};
+    if ((cqe.res > 0) && (it != m_handlers.end()) &&
+        (it->second.generation == generation)) {
+      it->second.target->handle_received(m_io_uring->get_buffer(
+          buffer_id, static_cast<std::size_t>(cqe.res)));
+    }
+    if (has_buffer == true) {
+      m_io_uring->recycle_buffer(buffer_id);
+    }
+
+    it = m_handlers.find(fd);
+    if ((it == m_handlers.end()) || (it->second.generation != generation)) {
+      break;
+    }
+
+    if ((cqe.flags & IORING_CQE_F_MORE) == 0) {
+      it->second.is_receive_armed = false;
+    }
+
+    // a receive cancelled by pause_reading() isn't a hangup, and a paused
+    // socket is only re-armed once reading resumes
+    if ((cqe.res == 0) ||
+        ((cqe.res < 0) && (cqe.res != -ENOBUFS) && (cqe.res != -ECANCELED))) {
+      it->second.target->handle_hangup();
+    } else if (((cqe.flags & IORING_CQE_F_MORE) == 0) &&
+               (it->second.is_reading_paused == false)) {
+      submit_receive(fd, generation);
+    }
+  } break;
+
+  case k_tag_send: {
+    send_request *request{
+        reinterpret_cast<send_request *>(cqe.user_data & ~k_tag_mask)};
+    m_sends_in_flight.erase(request);
+
+    std::unordered_map<int, registration>::iterator it{
+        m_handlers.find(request->fd)};
+    if ((it != m_handlers.end()) &&
+        (it->second.generation == request->generation)) {
+      --it->second.sends_in_flight;
+
+      if ((cqe.res < 0) ||
+          (static_cast<std::size_t>(cqe.res) < request->data.size())) {
+        it->second.target->handle_hangup();
+      } else if (it->second.sends_in_flight == 0) {
+        if (it->second.queued_sends.empty() == false) {
+          m_send_ready_fds.push_back(request->fd);
+        } else if (it->second.is_write_pending == true) {
+          it->second.is_write_pending = false;
+          it->second.target->handle_writable();
+        }
+      }
+    }
+
+    delete request;
+  } break;
+
+  default:
+    break;
+  }
+}
+
+void vassal::irc::event_loop::run_timers() {
+  if (m_timers.empty() == true) {
+    return;
+  }
+
+  const std::chrono::steady_clock::time_point now{
+      std::chrono::steady_clock::now()};
+
+  while ((m_timers.empty() == false) && (m_timers.begin()->first <= now)) {
+    const int fd{m_timers.begin()->second};
+    m_timers.erase(m_timers.begin());
+
+    std::unordered_map<int, registration>::iterator it{m_handlers.find(fd)};
+    if (it != m_handlers.end()) {
+      it->second.timer_deadline = std::chrono::steady_clock::time_point::max();
+      it->second.target->handle_timer();
+    }
+  }
+
+  arm_timer();
+}
+
+void vassal::irc::event_loop::arm_timer() {
+  itimerspec timer{};
+
+  if (m_timers.empty() == false) {
+    const std::chrono::nanoseconds deadline{
+        m_timers.begin()->first.time_since_epoch()};
+    const std::chrono::seconds seconds{
+        std::chrono::duration_cast<std::chrono::seconds>(deadline)};
+
+    timer.it_value.tv_sec = static_cast<time_t>(seconds.count());
+    timer.it_value.tv_nsec = static_cast<long>((deadline - seconds).count());
+
+    // an all-zero value would disarm the timer instead
+    if ((timer.it_value.tv_sec == 0) && (timer.it_value.tv_nsec == 0)) {
+      timer.it_value.tv_nsec = 1;
+    }
+  }
+
+  ::timerfd_settime(m_timer_fd, TFD_TIMER_ABSTIME, &timer, nullptr);
+}
+
+void vassal::irc::event_loop::wake_up() {
+  const std::uint64_t value{1};
+  [[maybe_unused]] const ssize_t written{
+      ::write(m_wakeup_fd, &value, sizeof(value))};
+}
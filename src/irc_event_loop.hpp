@@ -0,0 +1,195 @@
+#ifndef VASSAL_IRC_EVENT_LOOP_HPP
+#define VASSAL_IRC_EVENT_LOOP_HPP
+
+#include "irc_io_uring.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace vassal {
+
+namespace irc {
+// Multiplexes many connections over a single thread. A loop can be driven
+// from the caller's thread with run() or from a thread of its own with
+// start(). Handlers are looked up by fd under the dispatch mutex, so once
+// remove() returns the handler will not be called again and may be destroyed.
+//
+// Two backends are available. With epoll the handler is told when its socket
+// is readable and reads by itself. With io_uring the loop keeps a multishot
+// receive armed on every socket and hands the handler the received bytes,
+// and outbound data queued through send() goes out as linked send chains
+// submitted from the loop thread. io_uring is used only when asked for and
+// supported by the kernel; otherwise the loop falls back to epoll.
+//
+// With io_uring a handler is only told to write while none of its sends are
+// in flight, so whatever it hasn't handed over yet stays with it. remove()
+// can wait for the sends already handed over to finish, and reports whether
+// any are still in flight; writing to the socket directly while they are
+// would interleave with them.
+//
+// Each registered fd may also hold one timer; its handler is called from the
+// loop thread once the deadline has passed. A handler with output pending
+// calls request_write() and is told from the loop thread when to write: once
+// its socket is writable with epoll, right away with io_uring.
+//
+// A handler that can't take any more input calls pause_reading(); its socket
+// is then left unread (EPOLLIN is dropped, or the multishot receive is
+// cancelled and not re-armed), so TCP pushes back on the server without the
+// loop thread ever blocking. resume_reading() may be called from any thread
+// and has the handler told from the loop thread.
+class event_loop {
+public:
+  enum class backend {
+    epoll = 0,
+    io_uring,
+    N,
+  };
+
+  class handler {
+  public:
+    virtual ~handler() = default;
+
+  public:
+    virtual void handle_readable() = 0;
+    virtual void handle_received(const std::string_view data) = 0;
+    virtual void handle_hangup() = 0;
+    virtual void handle_timer() = 0;
+    virtual void handle_writable() = 0;
+    virtual void handle_resumed() = 0;
+  };
+
+private:
+  struct send_request {
+    int fd;
+    std::uint32_t generation;
+    std::string data;
+  };
+
+  struct registration {
+    handler *target;
+    std::uint32_t generation;
+    std::deque<send_request *> queued_sends;
+    std::size_t sends_in_flight;
+    std::chrono::steady_clock::time_point timer_deadline;
+    bool is_write_watched;  // epoll only
+    bool is_reading_paused;
+    bool is_receive_armed; // io_uring only
+    bool is_write_pending; // io_uring only, told once its sends are done
+  };
+
+  enum class operation_kind {
+    arm_receive = 0,
+    cancel_receive,
+    notify_writable,
+    resume_receive,
+    N,
+  };
+
+  struct pending_operation {
+    operation_kind kind;
+    int fd;
+    std::uint32_t generation;
+  };
+
+private:
+  backend m_backend;
+  int m_epoll_fd;
+  int m_wakeup_fd;
+  int m_timer_fd;
+  std::unique_ptr<io_uring_context> m_io_uring;
+  std::uint64_t m_wakeup_value;
+  std::uint64_t m_timer_value;
+
+  std::unordered_map<int, registration> m_handlers;
+  std::recursive_mutex m_handlers_mutex;
+  std::uint32_t m_next_generation;
+  std::set<std::pair<std::chrono::steady_clock::time_point, int>> m_timers;
+
+  std::vector<pending_operation> m_pending_operations;
+  std::mutex m_pending_operations_mutex;
+  std::unordered_set<send_request *> m_sends_in_flight;
+  std::vector<int> m_send_ready_fds;
+  std::condition_variable_any m_sends_done;
+  std::size_t m_sends_done_waiter_count;
+
+  std::thread m_thread;
+  std::atomic<std::thread::id> m_running_thread_id;
+  std::atomic<bool> m_stop;
+
+private:
+  static constexpr int m_k_max_events{64};
+  static constexpr std::uint32_t m_k_io_uring_entries{256};
+  static constexpr std::uint16_t m_k_io_uring_buffer_group{0};
+  static constexpr std::uint16_t m_k_io_uring_buffer_count{256};
+  static constexpr std::size_t m_k_io_uring_buffer_size{4096};
+
+public:
+  explicit event_loop(const backend preferred_backend = backend::epoll);
+
+  event_loop(const event_loop &other) = delete;
+  event_loop(event_loop &&other) = delete;
+
+  ~event_loop();
+
+public:
+  void add(const int fd, handler *handler);
+  void update(const int fd, handler *handler);
+  bool remove(const int fd,
+              const std::chrono::steady_clock::time_point send_deadline =
+                  std::chrono::steady_clock::time_point::min());
+  void send(const int fd, std::string &&data);
+  void request_write(const int fd);
+  void pause_reading(const int fd);
+  void resume_reading(const int fd);
+  void set_timer(const int fd,
+                 const std::chrono::steady_clock::time_point deadline);
+
+  void run();
+  void start();
+  void stop();
+
+  backend get_backend() const;
+  std::size_t get_handler_count();
+
+public:
+  event_loop &operator=(const event_loop &other) = delete;
+  event_loop &operator=(event_loop &&other) = delete;
+
+private:
+  void run_epoll();
+  void run_io_uring();
+
+  int watch_epoll_events(const int fd, const registration &watched);
+
+  void post(const pending_operation &operation);
+  void submit_pending_operations();
+  bool are_sends_done(const int fd);
+  void submit_receive(const int fd, const std::uint32_t generation);
+  void submit_queued_sends(const int fd);
+  void submit_wakeup_read();
+  void submit_timer_read();
+  void handle_completion(const io_uring_cqe &cqe);
+
+  void run_timers();
+  void arm_timer();
+
+  void wake_up();
+};
+} // namespace irc
+
+} // namespace vassal
+#endif
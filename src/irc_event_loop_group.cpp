@@ -0,0 +1,49 @@
+#include "irc_event_loop_group.hpp"
+
+#include "irc_event_loop.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+vassal::irc::event_loop_group::event_loop_group(
+    const std::size_t thread_count,
+    const event_loop::backend
+        preferred_backend /*= event_loop::backend::epoll*/)
+    : m_loops{} {
+  if (thread_count == 0) {
+    throw std::runtime_error{"event loop group needs at least one thread"};
+  }
+
+  m_loops.reserve(thread_count);
+  for (std::size_t i{0}; i < thread_count; ++i) {
+    m_loops.emplace_back(new event_loop{preferred_backend})->start();
+  }
+}
+
+vassal::irc::event_loop_group::~event_loop_group() {}
+
+vassal::irc::event_loop &vassal::irc::event_loop_group::get_loop() {
+  std::size_t least_loaded{0};
+  std::size_t least_handler_count{m_loops[0]->get_handler_count()};
+
+  for (std::size_t i{1}; i < m_loops.size(); ++i) {
+    const std::size_t handler_count{m_loops[i]->get_handler_count()};
+    if (handler_count < least_handler_count) {
+      least_loaded = i;
+      least_handler_count = handler_count;
+    }
+  }
+
+  return *m_loops[least_loaded];
+}
+
+vassal::irc::event_loop &
+vassal::irc::event_loop_group::get_loop(const std::size_t index) {
+  return *m_loops.at(index);
+}
+
+std::size_t vassal::irc::event_loop_group::get_thread_count() const {
+  return m_loops.size();
+}
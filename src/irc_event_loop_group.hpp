@@ -0,0 +1,41 @@
+#ifndef VASSAL_IRC_EVENT_LOOP_GROUP_HPP
+#define VASSAL_IRC_EVENT_LOOP_GROUP_HPP
+
+#include "irc_event_loop.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace vassal {
+
+namespace irc {
+// A fixed set of event loops, each on its own thread. New connections are
+// sharded onto whichever loop currently has the fewest of them.
+class event_loop_group {
+private:
+  std::vector<std::unique_ptr<event_loop>> m_loops;
+
+public:
+  explicit event_loop_group(const std::size_t thread_count,
+                            const event_loop::backend preferred_backend =
+                                event_loop::backend::epoll);
+
+  event_loop_group(const event_loop_group &other) = delete;
+  event_loop_group(event_loop_group &&other) = delete;
+
+  ~event_loop_group();
+
+public:
+  event_loop &get_loop();
+  event_loop &get_loop(const std::size_t index);
+  std::size_t get_thread_count() const;
+
+public:
+  event_loop_group &operator=(const event_loop_group &other) = delete;
+  event_loop_group &operator=(event_loop_group &&other) = delete;
+};
+} // namespace irc
+
+} // namespace vassal
+#endif
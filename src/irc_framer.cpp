@@ -0,0 +1,283 @@
+#include "irc_framer.hpp"
+
+#include "irc_receive_buffer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VASSAL_IRC_FRAMER_X86
+#endif
+
+namespace {
+constexpr char k_line_feed{'\n'};
+constexpr char k_carriage_return{'\r'};
+constexpr std::string_view k_ping{"PING"};
+
+// tags and a prefix are skipped without tokenising; returns the position of
+// the command token, or npos if the line ends before one
+std::size_t skip_tags_and_prefix(const std::string_view line) {
+  std::size_t pos{0};
+
+  for (const char marker : {'@', ':'}) {
+    if ((pos < line.size()) && (line[pos] == marker)) {
+      pos = line.find(' ', pos);
+      if (pos == std::string_view::npos) {
+        return std::string_view::npos;
+      }
+      pos = line.find_first_not_of(' ', pos);
+      if (pos == std::string_view::npos) {
+        return std::string_view::npos;
+      }
+    }
+  }
+
+  return pos;
+}
+
+using scan_function = void (*)(const char *data, std::size_t pos,
+                               const std::size_t end,
+                               std::vector<std::size_t> &line_feeds);
+
+void scan_line_feeds_scalar(const char *data, std::size_t pos,
+                            const std::size_t end,
+                            std::vector<std::size_t> &line_feeds) {
+  while (pos < end) {
+    const void *found{std::memchr((data + pos), k_line_feed, (end - pos))};
+    if (found == nullptr) {
+      break;
+    }
+
+    pos = static_cast<std::size_t>(static_cast<const char *>(found) - data);
+    line_feeds.push_back(pos);
+    ++pos;
+  }
+}
+
+#ifdef VASSAL_IRC_FRAMER_X86
+__attribute__((target("sse2"))) void
+scan_line_feeds_sse2(const char *data, std::size_t pos, const std::size_t end,
+                     std::vector<std::size_t> &line_feeds) {
+  static constexpr std::size_t k_stride{sizeof(__m128i)};
+
+  const __m128i line_feed{_mm_set1_epi8(k_line_feed)};
+
+  for (; (pos + k_stride) <= end; pos += k_stride) {
+    const __m128i chunk{
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos))};
+    std::uint32_t mask{static_cast<std::uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, line_feed)))};
+
+    while (mask != 0) {
+      line_feeds.push_back(pos + __builtin_ctz(mask));
+      mask &= (mask - 1);
+    }
+  }
+
+  scan_line_feeds_scalar(data, pos, end, line_feeds);
+}
+
+__attribute__((target("avx2"))) void
+scan_line_feeds_avx2(const char *data, std::size_t pos, const std::size_t end,
+                     std::vector<std::size_t> &line_feeds) {
+  static constexpr std::size_t k_stride{sizeof(__m256i)};
+
+  const __m256i line_feed{_mm256_set1_epi8(k_line_feed)};
+
+  for (; (pos + k_stride) <= end; pos += k_stride) {
+    const __m256i chunk{
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos))};
+    std::uint32_t mask{static_cast<std::uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, line_feed)))};
+
+    while (mask != 0) {
+      line_feeds.push_back(pos + __builtin_ctz(mask));
+      mask &= (mask - 1);
+    }
+  }
+
+  scan_line_feeds_sse2(data, pos, end, line_feeds);
+}
+#endif // VASSAL_IRC_FRAMER_X86
+
+vassal::irc::framer::scan_implementation select_scan_implementation() {
+#ifdef VASSAL_IRC_FRAMER_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return vassal::irc::framer::scan_implementation::avx2;
+  } else if (__builtin_cpu_supports("sse2")) {
+    return vassal::irc::framer::scan_implementation::sse2;
+  }
+#endif // VASSAL_IRC_FRAMER_X86
+  return vassal::irc::framer::scan_implementation::scalar;
+}
+
+scan_function select_scan_function() {
+  switch (vassal::irc::framer::get_scan_implementation()) {
+#ifdef VASSAL_IRC_FRAMER_X86
+  case vassal::irc::framer::scan_implementation::avx2:
+    return &scan_line_feeds_avx2;
+    break;
+  case vassal::irc::framer::scan_implementation::sse2:
+    return &scan_line_feeds_sse2;
+    break;
+#endif // VASSAL_IRC_FRAMER_X86
+  default:
+    return &scan_line_feeds_scalar;
+    break;
+  }
+}
+} // namespace
+
+vassal::irc::framer::framer()
+    : m_receive_buffer_pool{}, m_buffer{m_receive_buffer_pool.acquire()},
+      m_line_start{0}, m_scan_pos{0}, m_line_feeds{}, m_lines{} {}
+
+vassal::irc::framer::framer(framer &&other) noexcept
+    : m_receive_buffer_pool{std::move(other.m_receive_buffer_pool)},
+      m_buffer{std::move(other.m_buffer)}, m_line_start{other.m_line_start},
+      m_scan_pos{other.m_scan_pos},
+      m_line_feeds{std::move(other.m_line_feeds)},
+      m_lines{std::move(other.m_lines)} {}
+
+vassal::irc::framer::~framer() {}
+
+std::span<char> vassal::irc::framer::prepare(const std::size_t min_size) {
+  if (m_buffer->get_free_space() < min_size) {
+    const std::string_view partial_line{m_buffer->get_view(
+        m_line_start, (m_buffer->get_size() - m_line_start))};
+
+    receive_buffer_ref new_buffer{
+        m_receive_buffer_pool.acquire(partial_line.size() + min_size)};
+    new_buffer->append(partial_line);
+
+    m_scan_pos -= m_line_start;
+    m_line_start = 0;
+    m_buffer = std::move(new_buffer);
+  }
+
+  return std::span<char>{m_buffer->get_free_data(),
+                         m_buffer->get_free_space()};
+}
+
+std::span<const vassal::irc::framer::line_span>
+vassal::irc::framer::commit(const std::size_t count) {
+  static const scan_function k_scan_function{select_scan_function()};
+
+  m_buffer->commit(count);
+
+  m_line_feeds.clear();
+  m_lines.clear();
+
+  const char *data{m_buffer->get_data()};
+  k_scan_function(data, m_scan_pos, m_buffer->get_size(), m_line_feeds);
+  m_scan_pos = m_buffer->get_size();
+
+  for (const std::size_t pos_line_feed : m_line_feeds) {
+    std::size_t pos_end{pos_line_feed};
+    if ((pos_end > m_line_start) &&
+        (data[pos_end - 1] == k_carriage_return)) {
+      --pos_end;
+    }
+
+    if (pos_end > m_line_start) {
+      const std::size_t size{pos_end - m_line_start};
+      m_lines.push_back(line_span{
+          m_line_start, size,
+          get_ping_params(std::string_view{(data + m_line_start), size})
+              .has_value()});
+    }
+
+    m_line_start = pos_line_feed + 1;
+  }
+
+  return std::span<const line_span>{m_lines};
+}
+
+std::span<const vassal::irc::framer::line_span>
+vassal::irc::framer::append(const std::string_view data) {
+  std::span<char> free_space{prepare(data.size())};
+  std::memcpy(free_space.data(), data.data(), data.size());
+  return commit(data.size());
+}
+
+const vassal::irc::receive_buffer_ref &
+vassal::irc::framer::get_buffer() const {
+  return m_buffer;
+}
+
+std::size_t vassal::irc::framer::get_allocated_bytes() const {
+  return m_receive_buffer_pool.get_allocated_bytes();
+}
+
+std::string_view vassal::irc::framer::get_line(const line_span line) const {
+  return m_buffer->get_view(line.pos, line.size);
+}
+
+std::optional<std::string_view>
+vassal::irc::framer::get_ping_params(const std::string_view line) {
+  const std::size_t pos{skip_tags_and_prefix(line)};
+  if (pos == std::string_view::npos) {
+    return std::nullopt;
+  }
+
+  if ((line.size() - pos) < k_ping.size()) {
+    return std::nullopt;
+  }
+  if (std::memcmp((line.data() + pos), k_ping.data(), k_ping.size()) != 0) {
+    return std::nullopt;
+  }
+
+  if ((pos + k_ping.size()) == line.size()) {
+    return std::string_view{};
+  }
+  if (line[pos + k_ping.size()] != ' ') {
+    return std::nullopt;
+  }
+
+  return line.substr(pos + k_ping.size() + 1);
+}
+
+std::string_view
+vassal::irc::framer::get_command_token(const std::string_view line) {
+  const std::size_t pos{skip_tags_and_prefix(line)};
+  if (pos == std::string_view::npos) {
+    return std::string_view{};
+  }
+
+  std::size_t end{line.find(' ', pos)};
+  if (end == std::string_view::npos) {
+    end = line.size();
+  }
+
+  return line.substr(pos, (end - pos));
+}
+
+vassal::irc::framer::scan_implementation
+vassal::irc::framer::get_scan_implementation() {
+  static const scan_implementation k_scan_implementation{
+      select_scan_implementation()};
+  return k_scan_implementation;
+}
+
+vassal::irc::framer &vassal::irc::framer::operator=(framer &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+
+  m_receive_buffer_pool = std::move(other.m_receive_buffer_pool);
+  m_buffer = std::move(other.m_buffer);
+  m_line_start = other.m_line_start;
+  m_scan_pos = other.m_scan_pos;
+  m_line_feeds = std::move(other.m_line_feeds);
+  m_lines = std::move(other.m_lines);
+
+  return *this;
+}
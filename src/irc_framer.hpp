@@ -0,0 +1,73 @@
+#ifndef VASSAL_IRC_FRAMER_HPP
+#define VASSAL_IRC_FRAMER_HPP
+
+#include "irc_receive_buffer.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace vassal {
+
+namespace irc {
+// Splits the inbound byte stream into lines. Bytes are written straight into
+// pooled receive buffers, which are used as a ring of segments: complete lines
+// are reported as offsets into the current segment and the trailing partial
+// line stays where it is. Only when a segment runs out of room is that partial
+// line carried over into the next one. PINGs are recognised here from the
+// first bytes of the line so they can be answered before anything is parsed.
+class framer {
+public:
+  struct line_span {
+    std::size_t pos;
+    std::size_t size;
+    bool is_ping;
+  };
+
+  enum class scan_implementation {
+    scalar,
+    sse2,
+    avx2,
+  };
+
+private:
+  receive_buffer_pool m_receive_buffer_pool;
+  receive_buffer_ref m_buffer;
+  std::size_t m_line_start;
+  std::size_t m_scan_pos;
+  std::vector<std::size_t> m_line_feeds;
+  std::vector<line_span> m_lines;
+
+public:
+  framer();
+  framer(framer &&other) noexcept;
+
+  framer(const framer &other) = delete;
+
+  ~framer();
+
+public:
+  std::span<char> prepare(const std::size_t min_size);
+  std::span<const line_span> commit(const std::size_t count);
+  std::span<const line_span> append(const std::string_view data);
+
+  const receive_buffer_ref &get_buffer() const;
+  std::size_t get_allocated_bytes() const;
+  std::string_view get_line(const line_span line) const;
+
+  static std::optional<std::string_view>
+  get_ping_params(const std::string_view line);
+  static std::string_view get_command_token(const std::string_view line);
+  static scan_implementation get_scan_implementation();
+
+public:
+  framer &operator=(framer &&other) noexcept;
+
+  framer &operator=(const framer &other) = delete;
+};
+} // namespace irc
+
+} // namespace vassal
+#endif
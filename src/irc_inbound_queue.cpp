@@ -0,0 +1,339 @@
+#include "irc_inbound_queue.hpp"
+
+#include "irc_event_count.hpp"
+#include "irc_interest_filter.hpp"
+#include "irc_message_view.hpp"
+#include "irc_ring_queue.hpp"
+#include "irc_spill_buffer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+
+vassal::irc::inbound_queue::inbound_queue(const config &queue_config)
+    : m_state{new state{}} {
+  m_state->mode = queue_config.mode;
+  m_state->policy = queue_config.policy;
+  m_state->droppable_commands = queue_config.droppable_commands;
+
+  if ((queue_config.mode == consumer_mode::single) &&
+      (queue_config.policy != overflow_policy::drop_oldest)) {
+    m_state->single_consumer_ring.reset(
+        new spsc_ring_queue<message_view>{queue_config.capacity});
+  } else {
+    m_state->mode = consumer_mode::multiple;
+    m_state->multiple_consumer_ring.reset(
+        new mpmc_ring_queue<message_view>{queue_config.capacity});
+  }
+
+  if (queue_config.policy == overflow_policy::spill) {
+    m_state->spilled.reset(new spill_buffer{queue_config.spill_directory});
+  }
+
+  m_state->closed = false;
+  m_state->spilled_size = 0;
+  m_state->dropped_count = 0;
+  m_state->spilled_count = 0;
+  m_state->is_space_callback_armed = false;
+}
+
+vassal::irc::inbound_queue::inbound_queue(inbound_queue &&other) noexcept
+    : m_state{std::move(other.m_state)} {}
+
+vassal::irc::inbound_queue::~inbound_queue() { close(); }
+
+bool vassal::irc::inbound_queue::push(message_view &&value) {
+  return push(std::move(value), true);
+}
+
+bool vassal::irc::inbound_queue::try_push(message_view &&value) {
+  return push(std::move(value), false);
+}
+
+void vassal::irc::inbound_queue::publish() { m_state->not_empty.notify(); }
+
+void vassal::irc::inbound_queue::set_space_callback(space_callback on_space) {
+  m_state->on_space = std::move(on_space);
+}
+
+bool vassal::irc::inbound_queue::arm_space_callback() {
+  m_state->is_space_callback_armed.store(true, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  // a consumer that made room before the flag went up won't have seen it
+  if ((m_state->closed == true) ||
+      (((m_state->mode == consumer_mode::single)
+            ? m_state->single_consumer_ring->get_size()
+            : m_state->multiple_consumer_ring->get_size()) <
+       get_capacity())) {
+    if (m_state->is_space_callback_armed.exchange(false) == true) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool vassal::irc::inbound_queue::pop(message_view &value) {
+  while (true) {
+    if (try_pop(value) == true) {
+      return true;
+    }
+
+    if (m_state->closed == true) {
+      return false;
+    }
+
+    const std::uint32_t epoch{m_state->not_empty.prepare_wait()};
+    if (try_pop(value) == true) {
+      m_state->not_empty.cancel_wait();
+      return true;
+    }
+    if (m_state->closed == true) {
+      m_state->not_empty.cancel_wait();
+      return false;
+    }
+    m_state->not_empty.wait(epoch);
+  }
+}
+
+bool vassal::irc::inbound_queue::try_pop(message_view &value) {
+  if (try_pop_ring(value) == false) {
+    return false;
+  }
+
+  notify_not_full();
+  return true;
+}
+
+std::size_t vassal::irc::inbound_queue::pop(
+    const std::span<message_view> values,
+    const std::chrono::steady_clock::time_point deadline) {
+  if (values.size() == 0) {
+    return 0;
+  }
+
+  while (true) {
+    const std::size_t count{try_pop(values)};
+    if ((count != 0) || (m_state->closed == true)) {
+      return count;
+    }
+
+    const std::uint32_t epoch{m_state->not_empty.prepare_wait()};
+    if ((m_state->closed == true) || (get_size() != 0)) {
+      m_state->not_empty.cancel_wait();
+      continue;
+    }
+
+    if (deadline == std::chrono::steady_clock::time_point::max()) {
+      m_state->not_empty.wait(epoch);
+    } else if (m_state->not_empty.wait_until(epoch, deadline) == false) {
+      return try_pop(values);
+    }
+  }
+}
+
+std::size_t
+vassal::irc::inbound_queue::try_pop(const std::span<message_view> values) {
+  std::size_t count{0};
+  while ((count < values.size()) && (try_pop_ring(values[count]) == true)) {
+    ++count;
+  }
+
+  if (count != 0) {
+    notify_not_full();
+  }
+
+  return count;
+}
+
+void vassal::irc::inbound_queue::close() {
+  if (m_state != nullptr) {
+    m_state->closed = true;
+    m_state->not_empty.notify();
+    m_state->not_full.notify();
+  }
+}
+
+bool vassal::irc::inbound_queue::is_closed() const {
+  return m_state->closed;
+}
+
+vassal::irc::inbound_queue::consumer_mode
+vassal::irc::inbound_queue::get_consumer_mode() const {
+  return m_state->mode;
+}
+
+vassal::irc::inbound_queue::overflow_policy
+vassal::irc::inbound_queue::get_overflow_policy() const {
+  return m_state->policy;
+}
+
+vassal::irc::inbound_queue::counters
+vassal::irc::inbound_queue::get_counters() const {
+  return counters{m_state->dropped_count.load(std::memory_order_relaxed),
+                  m_state->spilled_count.load(std::memory_order_relaxed)};
+}
+
+std::size_t vassal::irc::inbound_queue::get_size() const {
+  return (((m_state->mode == consumer_mode::single)
+               ? m_state->single_consumer_ring->get_size()
+               : m_state->multiple_consumer_ring->get_size()) +
+          m_state->spilled_size.load(std::memory_order_acquire));
+}
+
+std::size_t vassal::irc::inbound_queue::get_capacity() const {
+  return ((m_state->mode == consumer_mode::single)
+              ? m_state->single_consumer_ring->get_capacity()
+              : m_state->multiple_consumer_ring->get_capacity());
+}
+
+vassal::irc::inbound_queue &
+vassal::irc::inbound_queue::operator=(inbound_queue &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+
+  close();
+  m_state = std::move(other.m_state);
+
+  return *this;
+}
+
+bool vassal::irc::inbound_queue::push(message_view &&value,
+                                       const bool is_blocking) {
+  switch (m_state->policy) {
+  case overflow_policy::drop_oldest:
+    return push_dropping_oldest(std::move(value));
+  case overflow_policy::drop_by_command:
+    if (try_push_ring(std::move(value)) == true) {
+      return true;
+    }
+    if (m_state->droppable_commands.is_interested(value.get_keyword()) ==
+        true) {
+      m_state->dropped_count.fetch_add(1, std::memory_order_relaxed);
+      return (m_state->closed == false);
+    }
+    break;
+  case overflow_policy::spill:
+    return push_spilling(std::move(value), is_blocking);
+  default:
+    break;
+  }
+
+  return ((is_blocking == true) ? push_blocking(std::move(value))
+                                : try_push_ring(std::move(value)));
+}
+
+bool vassal::irc::inbound_queue::push_blocking(message_view &&value) {
+  while (true) {
+    if (try_push_ring(std::move(value)) == true) {
+      return true;
+    }
+
+    if (m_state->closed == true) {
+      return false;
+    }
+
+    publish();
+
+    const std::uint32_t epoch{m_state->not_full.prepare_wait()};
+    if (try_push_ring(std::move(value)) == true) {
+      m_state->not_full.cancel_wait();
+      return true;
+    }
+    if (m_state->closed == true) {
+      m_state->not_full.cancel_wait();
+      return false;
+    }
+    m_state->not_full.wait(epoch);
+  }
+}
+
+bool vassal::irc::inbound_queue::push_dropping_oldest(message_view &&value) {
+  while (try_push_ring(std::move(value)) == false) {
+    if (m_state->closed == true) {
+      return false;
+    }
+
+    message_view oldest{};
+    if (m_state->multiple_consumer_ring->try_pop(oldest) == true) {
+      m_state->dropped_count.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  return true;
+}
+
+bool vassal::irc::inbound_queue::push_spilling(message_view &&value,
+                                                const bool is_blocking) {
+  // once anything has spilled, later messages follow it into the file until
+  // consumers have drained it, so ordering is kept
+  if ((m_state->spilled_size.load(std::memory_order_acquire) == 0) &&
+      (try_push_ring(std::move(value)) == true)) {
+    return true;
+  }
+
+  {
+    std::unique_lock<std::mutex> spilled_lock{m_state->spilled_mutex};
+
+    if ((m_state->spilled->is_empty() == true) &&
+        (try_push_ring(std::move(value)) == true)) {
+      return true;
+    }
+
+    if (m_state->spilled->push(value.get_raw_message()) == true) {
+      m_state->spilled_size.fetch_add(1, std::memory_order_release);
+      m_state->spilled_count.fetch_add(1, std::memory_order_relaxed);
+      return (m_state->closed == false);
+    }
+  }
+
+  // the spill file could not be written to
+  return ((is_blocking == true) ? push_blocking(std::move(value))
+                                : try_push_ring(std::move(value)));
+}
+
+void vassal::irc::inbound_queue::notify_not_full() {
+  m_state->not_full.notify();
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if ((m_state->is_space_callback_armed.load(std::memory_order_relaxed) ==
+       true) &&
+      (m_state->is_space_callback_armed.exchange(false) == true) &&
+      (m_state->on_space != nullptr)) {
+    m_state->on_space();
+  }
+}
+
+bool vassal::irc::inbound_queue::try_push_ring(message_view &&value) {
+  return ((m_state->mode == consumer_mode::single)
+              ? m_state->single_consumer_ring->try_push(std::move(value))
+              : m_state->multiple_consumer_ring->try_push(std::move(value)));
+}
+
+bool vassal::irc::inbound_queue::try_pop_ring(message_view &value) {
+  if (((m_state->mode == consumer_mode::single)
+           ? m_state->single_consumer_ring->try_pop(value)
+           : m_state->multiple_consumer_ring->try_pop(value)) == true) {
+    return true;
+  }
+
+  if (m_state->spilled_size.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+
+  std::unique_lock<std::mutex> spilled_lock{m_state->spilled_mutex};
+  if (m_state->spilled->pop(value) == false) {
+    return false;
+  }
+  m_state->spilled_size.fetch_sub(1, std::memory_order_release);
+
+  return true;
+}
@@ -0,0 +1,140 @@
+#ifndef VASSAL_IRC_INBOUND_QUEUE_HPP
+#define VASSAL_IRC_INBOUND_QUEUE_HPP
+
+#include "irc_event_count.hpp"
+#include "irc_interest_filter.hpp"
+#include "irc_message_view.hpp"
+#include "irc_ring_queue.hpp"
+#include "irc_spill_buffer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+
+namespace vassal {
+
+namespace irc {
+// Hands parsed messages from the listener thread to consumers. The listener
+// is the only producer; consumers that promise to be the only reader get the
+// cheaper single-consumer ring. Sleeping consumers are woken once per
+// published batch, and only if one actually went to sleep on an empty queue.
+// The capacity is fixed; what the listener does when the ring is full is
+// chosen by the overflow policy.
+//
+// A producer that must not block (an event loop thread serving other
+// connections too) uses try_push() instead, which gives the message back
+// wherever push() would have waited for room. It can then arm the space
+// callback, which the next consumer to make room calls once.
+class inbound_queue {
+public:
+  enum class consumer_mode {
+    single = 0,
+    multiple,
+    N,
+  };
+
+  enum class overflow_policy {
+    block = 0,       // stop reading the socket until there is room (TCP
+                     // backpressure)
+    drop_oldest,     // discard the oldest queued message (always uses the
+                     // multiple consumer ring, since the listener pops too)
+    drop_by_command, // discard new messages matching droppable_commands,
+                     // block for the rest
+    spill,           // append to a temporary file in spill_directory and
+                     // hand those out once the ring has drained
+    N,
+  };
+
+  struct config {
+    std::size_t capacity{4096};
+    consumer_mode mode{consumer_mode::multiple};
+    overflow_policy policy{overflow_policy::block};
+    interest_filter droppable_commands{};
+    std::string spill_directory{"/tmp"};
+  };
+
+  struct counters {
+    std::size_t dropped_messages;
+    std::size_t spilled_messages;
+  };
+
+  using space_callback = std::function<void()>;
+
+private:
+  struct state {
+    consumer_mode mode;
+    overflow_policy policy;
+    interest_filter droppable_commands;
+    std::unique_ptr<spsc_ring_queue<message_view>> single_consumer_ring;
+    std::unique_ptr<mpmc_ring_queue<message_view>> multiple_consumer_ring;
+    event_count not_empty;
+    event_count not_full;
+    std::atomic<bool> closed;
+    std::unique_ptr<spill_buffer> spilled;
+    std::mutex spilled_mutex;
+    std::atomic<std::size_t> spilled_size;
+    std::atomic<std::size_t> dropped_count;
+    std::atomic<std::size_t> spilled_count;
+    space_callback on_space;
+    std::atomic<bool> is_space_callback_armed;
+  };
+
+private:
+  std::unique_ptr<state> m_state;
+
+public:
+  explicit inbound_queue(const config &queue_config);
+  inbound_queue(inbound_queue &&other) noexcept;
+
+  inbound_queue(const inbound_queue &other) = delete;
+
+  ~inbound_queue();
+
+public:
+  bool push(message_view &&value);
+  bool try_push(message_view &&value);
+  void publish();
+
+  void set_space_callback(space_callback on_space);
+  bool arm_space_callback();
+
+  bool pop(message_view &value);
+  bool try_pop(message_view &value);
+  std::size_t pop(const std::span<message_view> values,
+                  const std::chrono::steady_clock::time_point deadline);
+  std::size_t try_pop(const std::span<message_view> values);
+
+  void close();
+  bool is_closed() const;
+
+  consumer_mode get_consumer_mode() const;
+  overflow_policy get_overflow_policy() const;
+  counters get_counters() const;
+  std::size_t get_size() const;
+  std::size_t get_capacity() const;
+
+public:
+  inbound_queue &operator=(inbound_queue &&other) noexcept;
+
+  inbound_queue &operator=(const inbound_queue &other) = delete;
+
+private:
+  bool push(message_view &&value, const bool is_blocking);
+  bool push_blocking(message_view &&value);
+  bool push_dropping_oldest(message_view &&value);
+  bool push_spilling(message_view &&value, const bool is_blocking);
+
+  void notify_not_full();
+
+  bool try_push_ring(message_view &&value);
+  bool try_pop_ring(message_view &value);
+};
+} // namespace irc
+
+} // namespace vassal
+#endif
@@ -0,0 +1,92 @@
+#include "irc_interest_filter.hpp"
+
+#include "irc_commands.hpp"
+#include "irc_numeric_codes.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+vassal::irc::interest_filter::interest_filter()
+    : m_commands{}, m_numeric_codes{}, m_is_accepting_all{true} {}
+
+vassal::irc::interest_filter::interest_filter(const interest_filter &other)
+    : m_commands{other.m_commands}, m_numeric_codes{other.m_numeric_codes},
+      m_is_accepting_all{other.m_is_accepting_all} {}
+
+vassal::irc::interest_filter::~interest_filter() {}
+
+void vassal::irc::interest_filter::add(const irc::command command) {
+  if (command >= irc::command::N) {
+    throw std::runtime_error{"invalid command"};
+  }
+
+  m_commands.set(static_cast<std::size_t>(command));
+  m_is_accepting_all = false;
+}
+
+void vassal::irc::interest_filter::add(const int numeric_code) {
+  if ((numeric_code < 0) || (numeric_code >= numeric_codes::k_code_count)) {
+    throw std::runtime_error{"invalid numeric code " +
+                             std::to_string(numeric_code)};
+  }
+
+  m_numeric_codes.set(static_cast<std::size_t>(numeric_code));
+  m_is_accepting_all = false;
+}
+
+void vassal::irc::interest_filter::remove(const irc::command command) {
+  if (command >= irc::command::N) {
+    throw std::runtime_error{"invalid command"};
+  }
+
+  m_commands.reset(static_cast<std::size_t>(command));
+}
+
+void vassal::irc::interest_filter::remove(const int numeric_code) {
+  if ((numeric_code < 0) || (numeric_code >= numeric_codes::k_code_count)) {
+    throw std::runtime_error{"invalid numeric code " +
+                             std::to_string(numeric_code)};
+  }
+
+  m_numeric_codes.reset(static_cast<std::size_t>(numeric_code));
+}
+
+void vassal::irc::interest_filter::reset() {
+  m_commands.reset();
+  m_numeric_codes.reset();
+  m_is_accepting_all = true;
+}
+
+bool vassal::irc::interest_filter::get_is_accepting_all() const {
+  return m_is_accepting_all;
+}
+
+bool vassal::irc::interest_filter::is_interested(
+    const std::string_view command_token) const {
+  if (m_is_accepting_all == true) {
+    return true;
+  }
+
+  const int numeric_code{numeric_codes::parse_code(command_token)};
+  if (numeric_code != -1) {
+    return m_numeric_codes.test(static_cast<std::size_t>(numeric_code));
+  }
+
+  return m_commands.test(
+      static_cast<std::size_t>(commands::lookup(command_token)));
+}
+
+vassal::irc::interest_filter &
+vassal::irc::interest_filter::operator=(const interest_filter &other) {
+  if (this == &other) {
+    return *this;
+  }
+
+  m_commands = other.m_commands;
+  m_numeric_codes = other.m_numeric_codes;
+  m_is_accepting_all = other.m_is_accepting_all;
+
+  return *this;
+}
@@ -0,0 +1,47 @@
+#ifndef VASSAL_IRC_INTEREST_FILTER_HPP
+#define VASSAL_IRC_INTEREST_FILTER_HPP
+
+#include "irc_commands.hpp"
+#include "irc_numeric_codes.hpp"
+
+#include <bitset>
+#include <cstddef>
+#include <string_view>
+
+namespace vassal {
+
+namespace irc {
+// Set of commands and numeric codes a connection wants to see. It is matched
+// against the raw command token of each framed line, so uninteresting lines
+// are dropped before they are parsed. A default constructed filter (or one
+// that has been reset) lets everything through.
+class interest_filter {
+private:
+  std::bitset<static_cast<std::size_t>(command::N)> m_commands;
+  std::bitset<static_cast<std::size_t>(numeric_codes::k_code_count)>
+      m_numeric_codes;
+  bool m_is_accepting_all;
+
+public:
+  interest_filter();
+  interest_filter(const interest_filter &other);
+
+  ~interest_filter();
+
+public:
+  void add(const irc::command command);
+  void add(const int numeric_code);
+  void remove(const irc::command command);
+  void remove(const int numeric_code);
+  void reset();
+
+  bool get_is_accepting_all() const;
+  bool is_interested(const std::string_view command_token) const;
+
+public:
+  interest_filter &operator=(const interest_filter &other);
+};
+} // namespace irc
+
+} // namespace vassal
+#endif
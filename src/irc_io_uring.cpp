@@ -0,0 +1,253 @@
+#include "irc_io_uring.hpp"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace {
+template <typename T> T *offset_ptr(void *base, const std::uint32_t offset) {
+  return reinterpret_cast<T *>(static_cast<std::byte *>(base) + offset);
+}
+
+std::uint32_t load_acquire(std::uint32_t *ptr) {
+  return std::atomic_ref<std::uint32_t>{*ptr}.load(std::memory_order_acquire);
+}
+
+void store_release(std::uint32_t *ptr, const std::uint32_t value) {
+  std::atomic_ref<std::uint32_t>{*ptr}.store(value, std::memory_order_release);
+}
+
+std::runtime_error make_error(const char *what, const int error) {
+  return std::runtime_error{std::string{what} + " (" + std::strerror(error) +
+                            ")"};
+}
+} // namespace
+
+vassal::irc::io_uring_context::io_uring_context(const std::uint32_t entries)
+    : m_fd{-1}, m_params{}, m_sq_ring{MAP_FAILED}, m_sq_ring_size{0},
+      m_cq_ring{MAP_FAILED}, m_cq_ring_size{0},
+      m_sqes{static_cast<io_uring_sqe *>(MAP_FAILED)}, m_sqes_size{0},
+      m_sq_head{nullptr}, m_sq_tail{nullptr}, m_sq_mask{0},
+      m_sq_array{nullptr}, m_sq_local_tail{0}, m_sq_submitted_tail{0},
+      m_cq_head{nullptr}, m_cq_tail{nullptr}, m_cq_mask{0}, m_cqes{nullptr},
+      m_buffer_ring{static_cast<io_uring_buf_ring *>(MAP_FAILED)},
+      m_buffer_ring_size{0}, m_buffers{nullptr}, m_buffer_count{0},
+      m_buffer_size{0}, m_buffer_group{0}, m_buffer_ring_tail{0} {
+  m_params.flags = IORING_SETUP_CLAMP;
+  m_fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &m_params));
+  if (m_fd == -1) {
+    throw make_error("io_uring_setup() failed", errno);
+  }
+
+  m_sq_ring_size =
+      m_params.sq_off.array + (m_params.sq_entries * sizeof(std::uint32_t));
+  m_cq_ring_size =
+      m_params.cq_off.cqes + (m_params.cq_entries * sizeof(io_uring_cqe));
+  if ((m_params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+    m_sq_ring_size = m_cq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size);
+  }
+
+  m_sq_ring = ::mmap(nullptr, m_sq_ring_size, (PROT_READ | PROT_WRITE),
+                     (MAP_SHARED | MAP_POPULATE), m_fd, IORING_OFF_SQ_RING);
+  if (m_sq_ring == MAP_FAILED) {
+    const int error{errno};
+    release();
+    throw make_error("failed to map io_uring submission ring", error);
+  }
+
+  if ((m_params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+    m_cq_ring = m_sq_ring;
+  } else {
+    m_cq_ring = ::mmap(nullptr, m_cq_ring_size, (PROT_READ | PROT_WRITE),
+                       (MAP_SHARED | MAP_POPULATE), m_fd, IORING_OFF_CQ_RING);
+    if (m_cq_ring == MAP_FAILED) {
+      const int error{errno};
+      release();
+      throw make_error("failed to map io_uring completion ring", error);
+    }
+  }
+
+  m_sqes_size = m_params.sq_entries * sizeof(io_uring_sqe);
+  m_sqes = static_cast<io_uring_sqe *>(
+      ::mmap(nullptr, m_sqes_size, (PROT_READ | PROT_WRITE),
+             (MAP_SHARED | MAP_POPULATE), m_fd, IORING_OFF_SQES));
+  if (m_sqes == MAP_FAILED) {
+    const int error{errno};
+    release();
+    throw make_error("failed to map io_uring submission entries", error);
+  }
+
+  m_sq_head = offset_ptr<std::uint32_t>(m_sq_ring, m_params.sq_off.head);
+  m_sq_tail = offset_ptr<std::uint32_t>(m_sq_ring, m_params.sq_off.tail);
+  m_sq_mask = *offset_ptr<std::uint32_t>(m_sq_ring, m_params.sq_off.ring_mask);
+  m_sq_array = offset_ptr<std::uint32_t>(m_sq_ring, m_params.sq_off.array);
+  m_sq_local_tail = m_sq_submitted_tail = *m_sq_tail;
+
+  m_cq_head = offset_ptr<std::uint32_t>(m_cq_ring, m_params.cq_off.head);
+  m_cq_tail = offset_ptr<std::uint32_t>(m_cq_ring, m_params.cq_off.tail);
+  m_cq_mask = *offset_ptr<std::uint32_t>(m_cq_ring, m_params.cq_off.ring_mask);
+  m_cqes = offset_ptr<io_uring_cqe>(m_cq_ring, m_params.cq_off.cqes);
+}
+
+vassal::irc::io_uring_context::~io_uring_context() { release(); }
+
+io_uring_sqe *vassal::irc::io_uring_context::get_sqe() {
+  if ((m_sq_local_tail - load_acquire(m_sq_head)) >= m_params.sq_entries) {
+    submit();
+    if ((m_sq_local_tail - load_acquire(m_sq_head)) >= m_params.sq_entries) {
+      throw std::runtime_error{"io_uring submission ring is full"};
+    }
+  }
+
+  const std::uint32_t index{m_sq_local_tail & m_sq_mask};
+  io_uring_sqe *sqe{&m_sqes[index]};
+  std::memset(sqe, 0, sizeof(io_uring_sqe));
+  m_sq_array[index] = index;
+  ++m_sq_local_tail;
+
+  return sqe;
+}
+
+int vassal::irc::io_uring_context::submit(
+    const std::uint32_t wait_count /*= 0*/) {
+  const std::uint32_t to_submit{m_sq_local_tail - m_sq_submitted_tail};
+  store_release(m_sq_tail, m_sq_local_tail);
+  m_sq_submitted_tail = m_sq_local_tail;
+
+  while (true) {
+    const int result{static_cast<int>(::syscall(
+        __NR_io_uring_enter, m_fd, to_submit, wait_count,
+        ((wait_count > 0) ? IORING_ENTER_GETEVENTS : 0), nullptr, 0))};
+
+    if ((result == -1) && (errno == EINTR)) {
+      if (wait_count > 0) {
+        return 0;
+      }
+      continue;
+    }
+    if (result == -1) {
+      throw make_error("io_uring_enter() failed", errno);
+    }
+
+    return result;
+  }
+}
+
+io_uring_cqe *vassal::irc::io_uring_context::peek_cqe() {
+  const std::uint32_t head{*m_cq_head};
+  if (head == load_acquire(m_cq_tail)) {
+    return nullptr;
+  }
+
+  return &m_cqes[head & m_cq_mask];
+}
+
+void vassal::irc::io_uring_context::consume_cqe() {
+  store_release(m_cq_head, (*m_cq_head + 1));
+}
+
+void vassal::irc::io_uring_context::register_buffer_ring(
+    const std::uint16_t group, const std::uint16_t buffer_count,
+    const std::size_t buffer_size) {
+  if ((buffer_count == 0) || ((buffer_count & (buffer_count - 1)) != 0)) {
+    throw std::runtime_error{"buffer ring size must be a power of two"};
+  }
+
+  m_buffer_ring_size = buffer_count * sizeof(io_uring_buf);
+  m_buffer_ring = static_cast<io_uring_buf_ring *>(
+      ::mmap(nullptr, m_buffer_ring_size, (PROT_READ | PROT_WRITE),
+             (MAP_PRIVATE | MAP_ANONYMOUS), -1, 0));
+  if (m_buffer_ring == MAP_FAILED) {
+    throw make_error("failed to allocate io_uring buffer ring", errno);
+  }
+
+  io_uring_buf_reg registration{};
+  registration.ring_addr = reinterpret_cast<std::uint64_t>(m_buffer_ring);
+  registration.ring_entries = buffer_count;
+  registration.bgid = group;
+
+  if (::syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_PBUF_RING,
+                &registration, 1) == -1) {
+    const int error{errno};
+    ::munmap(m_buffer_ring, m_buffer_ring_size);
+    m_buffer_ring = static_cast<io_uring_buf_ring *>(MAP_FAILED);
+    throw make_error("failed to register io_uring buffer ring", error);
+  }
+
+  m_buffers = new std::byte[buffer_count * buffer_size];
+  m_buffer_count = buffer_count;
+  m_buffer_size = buffer_size;
+  m_buffer_group = group;
+  m_buffer_ring_tail = 0;
+
+  for (std::uint16_t i{0}; i < buffer_count; ++i) {
+    recycle_buffer(i);
+  }
+}
+
+std::uint16_t vassal::irc::io_uring_context::get_buffer_group() const {
+  return m_buffer_group;
+}
+
+std::string_view
+vassal::irc::io_uring_context::get_buffer(const std::uint16_t buffer_id,
+                                          const std::size_t size) const {
+  return std::string_view{
+      reinterpret_cast<const char *>(m_buffers + (buffer_id * m_buffer_size)),
+      size};
+}
+
+void vassal::irc::io_uring_context::recycle_buffer(
+    const std::uint16_t buffer_id) {
+  // the uapi header declares bufs through __DECLARE_FLEX_ARRAY, whose empty
+  // placeholder member shifts the array by a byte in C++, so the entries are
+  // indexed from the start of the ring instead
+  io_uring_buf &buffer{reinterpret_cast<io_uring_buf *>(
+      m_buffer_ring)[m_buffer_ring_tail & (m_buffer_count - 1)]};
+  buffer.addr =
+      reinterpret_cast<std::uint64_t>(m_buffers + (buffer_id * m_buffer_size));
+  buffer.len = static_cast<std::uint32_t>(m_buffer_size);
+  buffer.bid = buffer_id;
+
+  ++m_buffer_ring_tail;
+  std::atomic_ref<std::uint16_t>{m_buffer_ring->tail}.store(
+      m_buffer_ring_tail, std::memory_order_release);
+}
+
+void vassal::irc::io_uring_context::release() {
+  if (m_fd != -1) {
+    ::close(m_fd);
+    m_fd = -1;
+  }
+
+  if (m_buffer_ring != MAP_FAILED) {
+    ::munmap(m_buffer_ring, m_buffer_ring_size);
+    m_buffer_ring = static_cast<io_uring_buf_ring *>(MAP_FAILED);
+  }
+  delete[] m_buffers;
+  m_buffers = nullptr;
+
+  if (m_sqes != MAP_FAILED) {
+    ::munmap(m_sqes, m_sqes_size);
+    m_sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+  }
+  if ((m_cq_ring != MAP_FAILED) && (m_cq_ring != m_sq_ring)) {
+    ::munmap(m_cq_ring, m_cq_ring_size);
+  }
+  m_cq_ring = MAP_FAILED;
+  if (m_sq_ring != MAP_FAILED) {
+    ::munmap(m_sq_ring, m_sq_ring_size);
+    m_sq_ring = MAP_FAILED;
+  }
+}
@@ -0,0 +1,81 @@
+#ifndef VASSAL_IRC_IO_URING_HPP
+#define VASSAL_IRC_IO_URING_HPP
+
+#include <linux/io_uring.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace vassal {
+
+namespace irc {
+// Minimal io_uring wrapper on top of the raw syscalls: the submission and
+// completion rings plus one provided-buffer ring for multishot receives.
+// Not thread-safe; only the thread driving the ring may touch it.
+class io_uring_context {
+private:
+  int m_fd;
+  io_uring_params m_params;
+
+  void *m_sq_ring;
+  std::size_t m_sq_ring_size;
+  void *m_cq_ring;
+  std::size_t m_cq_ring_size;
+  io_uring_sqe *m_sqes;
+  std::size_t m_sqes_size;
+
+  std::uint32_t *m_sq_head;
+  std::uint32_t *m_sq_tail;
+  std::uint32_t m_sq_mask;
+  std::uint32_t *m_sq_array;
+  std::uint32_t m_sq_local_tail;
+  std::uint32_t m_sq_submitted_tail;
+
+  std::uint32_t *m_cq_head;
+  std::uint32_t *m_cq_tail;
+  std::uint32_t m_cq_mask;
+  io_uring_cqe *m_cqes;
+
+  io_uring_buf_ring *m_buffer_ring;
+  std::size_t m_buffer_ring_size;
+  std::byte *m_buffers;
+  std::uint16_t m_buffer_count;
+  std::size_t m_buffer_size;
+  std::uint16_t m_buffer_group;
+  std::uint16_t m_buffer_ring_tail;
+
+public:
+  explicit io_uring_context(const std::uint32_t entries);
+
+  io_uring_context(const io_uring_context &other) = delete;
+  io_uring_context(io_uring_context &&other) = delete;
+
+  ~io_uring_context();
+
+public:
+  io_uring_sqe *get_sqe();
+  int submit(const std::uint32_t wait_count = 0);
+
+  io_uring_cqe *peek_cqe();
+  void consume_cqe();
+
+  void register_buffer_ring(const std::uint16_t group,
+                            const std::uint16_t buffer_count,
+                            const std::size_t buffer_size);
+  std::uint16_t get_buffer_group() const;
+  std::string_view get_buffer(const std::uint16_t buffer_id,
+                              const std::size_t size) const;
+  void recycle_buffer(const std::uint16_t buffer_id);
+
+public:
+  io_uring_context &operator=(const io_uring_context &other) = delete;
+  io_uring_context &operator=(io_uring_context &&other) = delete;
+
+private:
+  void release();
+};
+} // namespace irc
+
+} // namespace vassal
+#endif
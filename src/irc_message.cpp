@@ -1,6 +1,8 @@
 #include "irc_message.hpp"
 
-#include <cctype>
+#include "irc_message_slab.hpp"
+#include "irc_message_view.hpp"
+
 #include <cstddef>
 #include <exception>
 #include <iostream>
@@ -9,58 +11,74 @@
 #include <string_view>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
-vassal::irc::message::message() : m_sender_info{}, m_recipient{}, m_body{} {}
+vassal::irc::message::message()
+    : m_sender_info{}, m_params{}, m_recipient{}, m_body{} {}
 
 vassal::irc::message::message(const std::string_view raw_message)
-    : m_sender_info{}, m_recipient{}, m_body{} {
-  parse_sender_info(raw_message);
-  parse_recipient(raw_message);
-  parse_body(raw_message);
-}
+    : message{message_view{raw_message}} {}
+
+vassal::irc::message::message(const message_view &view)
+    : m_sender_info{std::string{view.get_sender_info().sender_nick},
+                    std::string{view.get_sender_info().sender_user},
+                    std::string{view.get_sender_info().sender_host}},
+      m_params{view.get_params().begin(), view.get_params().end()},
+      m_recipient{view.get_recipient()}, m_body{view.get_body()} {}
 
 vassal::irc::message::message(const message &other)
-    : m_sender_info{other.m_sender_info}, m_recipient{other.m_recipient},
-      m_body{other.m_body} {}
+    : m_sender_info{other.m_sender_info}, m_params{other.m_params},
+      m_recipient{other.m_recipient}, m_body{other.m_body} {}
 
 vassal::irc::message::message(message &&other) noexcept
     : m_sender_info{std::move(other.m_sender_info)},
+      m_params{std::move(other.m_params)},
       m_recipient{std::move(other.m_recipient)},
       m_body{std::move(other.m_body)} {}
 
 vassal::irc::message::~message() {}
 
-vassal::irc::message::sender_info
+const vassal::irc::message::sender_info &
 vassal::irc::message::get_sender_info() const {
   return m_sender_info;
 }
 
-std::string vassal::irc::message::get_recipient() const { return m_recipient; }
+const std::vector<std::string> &vassal::irc::message::get_params() const {
+  return m_params;
+}
+
+const std::string &vassal::irc::message::get_recipient() const {
+  return m_recipient;
+}
 
-std::string vassal::irc::message::get_body() const { return m_body; }
+const std::string &vassal::irc::message::get_body() const { return m_body; }
 
 vassal::irc::message::type
 vassal::irc::message::check_type(const std::string_view raw_message) {
-  static constexpr std::string::size_type k_type_pos_word{2};
-  static constexpr char k_delimiter_space{' '};
+  return message_view{raw_message}.get_type();
+}
 
-  std::string::size_type pos_last{std::string::npos};
-  std::string::size_type pos_cur{std::string::npos};
+void *vassal::irc::message::operator new(std::size_t size) {
+  return message_slab::allocate_unpooled(size);
+}
 
-  for (size_t i{0}; i < k_type_pos_word; ++i) {
-    pos_last = pos_cur;
-    pos_cur = raw_message.find(k_delimiter_space, (pos_last + 1));
-  }
+void *vassal::irc::message::operator new(std::size_t size,
+                                         message_slab &slab) {
+  return slab.allocate(size);
+}
 
-  if (std::isdigit(raw_message[pos_last + 1]) == true) {
-    return type::numeric;
-  } else {
-    return type::standard;
-  }
+void vassal::irc::message::operator delete(void *ptr) {
+  message_slab::deallocate(ptr);
+}
+
+void vassal::irc::message::operator delete(void *ptr,
+                                           message_slab & /*slab*/) {
+  message_slab::deallocate(ptr);
 }
 
 vassal::irc::message &vassal::irc::message::operator=(const message &other) {
   m_sender_info = other.m_sender_info;
+  m_params = other.m_params;
   m_recipient = other.m_recipient;
   m_body = other.m_body;
 
@@ -68,8 +86,10 @@ vassal::irc::message &vassal::irc::message::operator=(const message &other) {
 }
 
 vassal::irc::message &vassal::irc::message::operator=(message &&other) noexcept(
-    std::is_nothrow_move_assignable_v<std::string>) {
+    std::is_nothrow_move_assignable_v<std::string> &&
+    std::is_nothrow_move_assignable_v<std::vector<std::string>>) {
   m_sender_info = std::move(other.m_sender_info);
+  m_params = std::move(other.m_params);
   m_recipient = std::move(other.m_recipient);
   m_body = std::move(other.m_body);
 
@@ -77,86 +97,30 @@ vassal::irc::message &vassal::irc::message::operator=(message &&other) noexcept(
 }
 
 void vassal::irc::message::print(std::ostream &out) const {
-  out << ':';
-  if (m_sender_info.sender_nick != "") {
-    out << m_sender_info.sender_nick << '!';
-  }
-  if (m_sender_info.sender_user != "") {
-    out << m_sender_info.sender_user << '@';
-  }
-  out << m_sender_info.sender_host;
-
-  out << ' ' << get_keyword();
-
-  out << ' ' << m_recipient;
-
-  out << ' ' << m_body;
-}
-
-void vassal::irc::message::parse_sender_info(
-    const std::string_view raw_message) {
-  static constexpr char k_delimiter_colon{':'};
-  static constexpr char k_delimiter_exclamation_mark{'!'};
-  static constexpr char k_delimiter_at_sign{'@'};
-  static constexpr char k_delimiter_space{' '};
-
-  const std::string_view sender_info_substr{
-      raw_message.substr(0, raw_message.find(k_delimiter_space))};
-
-  const std::string::size_type pos_colon{
-      sender_info_substr.find(k_delimiter_colon)};
-  const std::string::size_type pos_exclamation_mark{
-      sender_info_substr.find(k_delimiter_exclamation_mark)};
-  const std::string::size_type pos_at_sign{
-      sender_info_substr.find(k_delimiter_at_sign)};
-
-  if ((pos_exclamation_mark == std::string::npos) &&
-      (pos_at_sign == std::string::npos)) {
-    m_sender_info.sender_nick = "";
-    m_sender_info.sender_user = "";
-    m_sender_info.sender_host = sender_info_substr.substr((pos_colon + 1));
-  } else if (!(pos_exclamation_mark == std::string::npos) !=
-             !(pos_at_sign == std::string::npos)) {
-    throw std::runtime_error{"if message sender contains one of [nick,user], "
-                             "it should contain both"};
-  } else {
-    m_sender_info.sender_nick = sender_info_substr.substr(
-        (pos_colon + 1), (pos_exclamation_mark - (pos_colon + 1)));
-    m_sender_info.sender_user = sender_info_substr.substr(
-        (pos_exclamation_mark + 1), (pos_at_sign - (pos_exclamation_mark + 1)));
-    m_sender_info.sender_host = sender_info_substr.substr((pos_at_sign + 1));
+  if ((m_sender_info.sender_nick != "") || (m_sender_info.sender_host != "")) {
+    out << ':';
+    if (m_sender_info.sender_nick != "") {
+      out << m_sender_info.sender_nick;
+      if (m_sender_info.sender_user != "") {
+        out << '!' << m_sender_info.sender_user;
+      }
+      out << '@';
+    }
+    out << m_sender_info.sender_host << ' ';
   }
-}
-
-void vassal::irc::message::parse_recipient(const std::string_view raw_message) {
-  static constexpr std::string::size_type k_recipient_pos_word{3};
-  static constexpr char k_delimiter_space{' '};
-
-  std::string::size_type pos_last{std::string::npos};
-  std::string::size_type pos_cur{std::string::npos};
 
-  for (size_t i{0}; i < k_recipient_pos_word; ++i) {
-    pos_last = pos_cur;
-    pos_cur = raw_message.find(k_delimiter_space, (pos_last + 1));
+  out << get_keyword();
+
+  for (size_t i{0}; i < m_params.size(); ++i) {
+    out << ' ';
+    if ((i == (m_params.size() - 1)) &&
+        ((m_params[i].empty() == true) ||
+         (m_params[i].find(' ') != std::string::npos) ||
+         (m_params[i].front() == ':'))) {
+      out << ':';
+    }
+    out << m_params[i];
   }
-
-  m_recipient =
-      raw_message.substr((pos_last + 1), ((pos_cur) - (pos_last + 1)));
-}
-
-void vassal::irc::message::parse_body(const std::string_view raw_message) {
-  static constexpr std::string::size_type k_body_pos_word{4};
-  static constexpr char k_delimiter_space{' '};
-
-  std::string::size_type pos_last{std::string::npos};
-  std::string::size_type pos_cur{std::string::npos};
-
-  for (size_t i{0}; i < k_body_pos_word; ++i) {
-    pos_last = pos_cur;
-    pos_cur = raw_message.find(k_delimiter_space, (pos_last + 1));
-  }
-
-  m_body = raw_message.substr((pos_last + 1));
 }
 
 std::ostream &vassal::irc::operator<<(std::ostream &out, const message &m) {
@@ -1,14 +1,19 @@
 #ifndef VASSAL_IRC_MESSAGE_HPP
 #define VASSAL_IRC_MESSAGE_HPP
 
+#include <cstddef>
 #include <iostream>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <vector>
 
 namespace vassal {
 
 namespace irc {
+class message_slab;
+class message_view;
+
 class message {
 public:
   enum class type {
@@ -24,12 +29,14 @@ public:
 
 private:
   sender_info m_sender_info;
+  std::vector<std::string> m_params;
   std::string m_recipient;
   std::string m_body;
 
 public:
   message();
   message(const std::string_view raw_message);
+  explicit message(const message_view &view);
   message(const message &other);
   message(message &&other) noexcept;
 
@@ -42,28 +49,30 @@ public:
   virtual type get_type() const = 0;
   virtual std::string get_keyword() const = 0;
 
-  sender_info get_sender_info() const;
-  std::string get_recipient() const;
-  std::string get_body() const;
+  const sender_info &get_sender_info() const;
+  const std::vector<std::string> &get_params() const;
+  const std::string &get_recipient() const;
+  const std::string &get_body() const;
 
 public:
   static type check_type(const std::string_view raw_message);
 
+  static void *operator new(std::size_t size);
+  static void *operator new(std::size_t size, message_slab &slab);
+  static void operator delete(void *ptr);
+  static void operator delete(void *ptr, message_slab &slab);
+
 public:
   message &operator=(const message &other);
   message &operator=(message &&other) noexcept(
-      std::is_nothrow_move_assignable_v<std::string>);
+      std::is_nothrow_move_assignable_v<std::string>
+          &&std::is_nothrow_move_assignable_v<std::vector<std::string>>);
 
 public:
   friend std::ostream &operator<<(std::ostream &out, const message &m);
 
 protected:
   virtual void print(std::ostream &out) const;
-
-private:
-  void parse_sender_info(const std::string_view raw_message);
-  void parse_recipient(const std::string_view raw_message);
-  void parse_body(const std::string_view raw_message);
 };
 
 std::ostream &operator<<(std::ostream &out, const message &m);
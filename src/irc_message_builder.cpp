@@ -0,0 +1,114 @@
+#include "irc_message_builder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+vassal::irc::message_builder::message_builder(const std::string_view command)
+    : m_buffer{}, m_size{0} {
+  append(command);
+}
+
+vassal::irc::message_builder::message_builder(const message_builder &other)
+    : m_buffer{}, m_size{other.m_size} {
+  std::copy_n(other.m_buffer.data(), other.m_size, m_buffer.data());
+}
+
+vassal::irc::message_builder::message_builder(message_builder &&other) noexcept
+    : m_buffer{}, m_size{other.m_size} {
+  std::copy_n(other.m_buffer.data(), other.m_size, m_buffer.data());
+}
+
+vassal::irc::message_builder::~message_builder() {}
+
+vassal::irc::message_builder &
+vassal::irc::message_builder::add_param(const std::string_view param) {
+  append(" ");
+  return append(param);
+}
+
+vassal::irc::message_builder &
+vassal::irc::message_builder::add_param(const long long number) {
+  std::array<char, 24> digits{};
+  const std::to_chars_result result{
+      std::to_chars(digits.data(), (digits.data() + digits.size()), number)};
+
+  append(" ");
+  return append(std::string_view{digits.data(),
+                                 static_cast<std::size_t>(result.ptr -
+                                                          digits.data())});
+}
+
+vassal::irc::message_builder &
+vassal::irc::message_builder::add_list(const std::vector<std::string> &items) {
+  append(" ");
+
+  for (size_t i{0}; i < items.size(); ++i) {
+    if ((i > 0) && (items[i] != "")) {
+      append(",");
+    }
+    append(items[i]);
+  }
+
+  return *this;
+}
+
+vassal::irc::message_builder &
+vassal::irc::message_builder::add_trailing(const std::string_view text) {
+  append(" :");
+  return append(text);
+}
+
+vassal::irc::message_builder &
+vassal::irc::message_builder::append(const std::string_view text) {
+  if ((m_size + text.size()) > m_k_max_length) {
+    throw std::runtime_error{"message is too long (over " +
+                             std::to_string(m_k_max_length) + " chars)"};
+  }
+
+  if (text.find_first_of(std::string_view{"\r\n\0", 3}) !=
+      std::string_view::npos) {
+    throw std::runtime_error{"message contains a line break or NUL"};
+  }
+
+  std::copy_n(text.data(), text.size(), (m_buffer.data() + m_size));
+  m_size += text.size();
+
+  return *this;
+}
+
+std::string_view vassal::irc::message_builder::get_view() const {
+  return std::string_view{m_buffer.data(), m_size};
+}
+
+std::size_t vassal::irc::message_builder::get_size() const { return m_size; }
+
+vassal::irc::message_builder &
+vassal::irc::message_builder::operator=(const message_builder &other) {
+  if (this == &other) {
+    return *this;
+  }
+
+  std::copy_n(other.m_buffer.data(), other.m_size, m_buffer.data());
+  m_size = other.m_size;
+
+  return *this;
+}
+
+vassal::irc::message_builder &
+vassal::irc::message_builder::operator=(message_builder &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+
+  std::copy_n(other.m_buffer.data(), other.m_size, m_buffer.data());
+  m_size = other.m_size;
+
+  return *this;
+}
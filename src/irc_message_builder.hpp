@@ -0,0 +1,50 @@
+#ifndef VASSAL_IRC_MESSAGE_BUILDER_HPP
+#define VASSAL_IRC_MESSAGE_BUILDER_HPP
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vassal {
+
+namespace irc {
+// Builds one outbound line in a fixed buffer that lives wherever the builder
+// does (on the stack, usually), so putting a command together never touches
+// the heap. The 510 byte limit is enforced as the line is written, and text
+// carrying CR, LF or NUL is refused so a parameter can never smuggle in a
+// second line.
+class message_builder {
+private:
+  std::array<char, 512> m_buffer;
+  std::size_t m_size;
+
+public:
+  static constexpr std::size_t m_k_max_length{510};
+
+public:
+  explicit message_builder(const std::string_view command);
+  message_builder(const message_builder &other);
+  message_builder(message_builder &&other) noexcept;
+
+  ~message_builder();
+
+public:
+  message_builder &add_param(const std::string_view param);
+  message_builder &add_param(const long long number);
+  message_builder &add_list(const std::vector<std::string> &items);
+  message_builder &add_trailing(const std::string_view text);
+  message_builder &append(const std::string_view text);
+
+  std::string_view get_view() const;
+  std::size_t get_size() const;
+
+public:
+  message_builder &operator=(const message_builder &other);
+  message_builder &operator=(message_builder &&other) noexcept;
+};
+} // namespace irc
+
+} // namespace vassal
+#endif
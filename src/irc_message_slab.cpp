@@ -0,0 +1,127 @@
+#include "irc_message_slab.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+vassal::irc::message_slab::message_slab() : m_state{new state{}} {
+  m_state->free_slots = nullptr;
+  m_state->returned_slots = nullptr;
+  m_state->reserved_bytes = 0;
+  m_state->slots_in_use = 0;
+  m_state->ref_count = 1;
+}
+
+vassal::irc::message_slab::message_slab(message_slab &&other) noexcept
+    : m_state{std::exchange(other.m_state, nullptr)} {}
+
+vassal::irc::message_slab::~message_slab() { close(); }
+
+void *vassal::irc::message_slab::allocate(const std::size_t size) {
+  if ((m_state == nullptr) || (size > m_k_payload_size)) {
+    return allocate_unpooled(size);
+  }
+
+  free_slot *slot{nullptr};
+  {
+    std::unique_lock<std::mutex> state_mutex_lock{m_state->mutex};
+
+    if (m_state->free_slots == nullptr) {
+      m_state->free_slots =
+          m_state->returned_slots.exchange(nullptr, std::memory_order_acquire);
+    }
+
+    if (m_state->free_slots == nullptr) {
+      static constexpr std::size_t k_block_size{m_k_slots_per_block *
+                                                m_k_slot_size};
+
+      std::byte *block{
+          m_state->blocks.emplace_back(new std::byte[k_block_size]).get()};
+      m_state->reserved_bytes.fetch_add(k_block_size,
+                                        std::memory_order_relaxed);
+
+      for (std::size_t i{m_k_slots_per_block}; i > 0; --i) {
+        m_state->free_slots = new (block + ((i - 1) * m_k_slot_size))
+            free_slot{m_state->free_slots};
+      }
+    }
+
+    slot = m_state->free_slots;
+    m_state->free_slots = slot->next;
+  }
+
+  m_state->slots_in_use.fetch_add(1, std::memory_order_relaxed);
+  m_state->ref_count.fetch_add(1, std::memory_order_relaxed);
+
+  return (reinterpret_cast<std::byte *>(new (slot) slot_header{m_state}) +
+          m_k_header_size);
+}
+
+vassal::irc::message_slab::usage vassal::irc::message_slab::get_usage() const {
+  if (m_state == nullptr) {
+    return usage{0, 0};
+  }
+
+  return usage{m_state->reserved_bytes.load(std::memory_order_relaxed),
+               m_state->slots_in_use.load(std::memory_order_relaxed)};
+}
+
+void *vassal::irc::message_slab::allocate_unpooled(const std::size_t size) {
+  void *ptr{::operator new(m_k_header_size + size)};
+  return (reinterpret_cast<std::byte *>(new (ptr) slot_header{nullptr}) +
+          m_k_header_size);
+}
+
+void vassal::irc::message_slab::deallocate(void *ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+
+  slot_header *header{reinterpret_cast<slot_header *>(
+      static_cast<std::byte *>(ptr) - m_k_header_size)};
+  state *owner{header->owner};
+
+  if (owner == nullptr) {
+    ::operator delete(header);
+    return;
+  }
+
+  free_slot *slot{new (header) free_slot{nullptr}};
+  slot->next = owner->returned_slots.load(std::memory_order_relaxed);
+  while (owner->returned_slots.compare_exchange_weak(
+             slot->next, slot, std::memory_order_release,
+             std::memory_order_relaxed) == false) {
+  }
+
+  owner->slots_in_use.fetch_sub(1, std::memory_order_relaxed);
+  release(owner);
+}
+
+vassal::irc::message_slab &
+vassal::irc::message_slab::operator=(message_slab &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+
+  close();
+  m_state = std::exchange(other.m_state, nullptr);
+
+  return *this;
+}
+
+void vassal::irc::message_slab::close() {
+  if (m_state != nullptr) {
+    release(m_state);
+    m_state = nullptr;
+  }
+}
+
+void vassal::irc::message_slab::release(state *state) {
+  if (state->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete state;
+  }
+}
@@ -0,0 +1,82 @@
+#ifndef VASSAL_IRC_MESSAGE_SLAB_HPP
+#define VASSAL_IRC_MESSAGE_SLAB_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vassal {
+
+namespace irc {
+// Per-connection slab that heap-allocated message objects are carved from.
+// Slots freed on consumer threads are pushed onto a lock-free return stack
+// and taken back in one go by the next allocation that runs dry, so memory
+// stays with the connection rather than drifting into per-thread malloc
+// arenas. The slab outlives its owner until the last slot is returned.
+class message_slab {
+public:
+  struct usage {
+    std::size_t reserved_bytes;
+    std::size_t slots_in_use;
+  };
+
+private:
+  struct free_slot {
+    free_slot *next;
+  };
+
+  struct state {
+    std::mutex mutex;
+    free_slot *free_slots;
+    std::atomic<free_slot *> returned_slots;
+    std::vector<std::unique_ptr<std::byte[]>> blocks;
+    std::atomic<std::size_t> reserved_bytes;
+    std::atomic<std::size_t> slots_in_use;
+    std::atomic<std::size_t> ref_count;
+  };
+
+  struct slot_header {
+    alignas(std::max_align_t) state *owner;
+  };
+
+private:
+  state *m_state;
+
+private:
+  static constexpr std::size_t m_k_slots_per_block{256};
+  static constexpr std::size_t m_k_header_size{sizeof(slot_header)};
+  static constexpr std::size_t m_k_payload_size{256};
+  static constexpr std::size_t m_k_slot_size{m_k_header_size +
+                                             m_k_payload_size};
+
+public:
+  message_slab();
+  message_slab(message_slab &&other) noexcept;
+
+  message_slab(const message_slab &other) = delete;
+
+  ~message_slab();
+
+public:
+  void *allocate(const std::size_t size);
+  usage get_usage() const;
+
+  static void *allocate_unpooled(const std::size_t size);
+  static void deallocate(void *ptr);
+
+public:
+  message_slab &operator=(message_slab &&other) noexcept;
+
+  message_slab &operator=(const message_slab &other) = delete;
+
+private:
+  void close();
+
+  static void release(state *state);
+};
+} // namespace irc
+
+} // namespace vassal
+#endif
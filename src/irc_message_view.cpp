@@ -0,0 +1,233 @@
+#include "irc_message_view.hpp"
+
+#include "irc_any_message.hpp"
+#include "irc_commands.hpp"
+#include "irc_message.hpp"
+#include "irc_message_slab.hpp"
+#include "irc_numeric_message.hpp"
+#include "irc_receive_buffer.hpp"
+#include "irc_standard_message.hpp"
+#include "irc_tokenizer.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+vassal::irc::message_view::message_view()
+    : m_buffer{}, m_raw_message{}, m_tokens{},
+      m_type{message::type::standard}, m_command{irc::command::unknown},
+      m_sender_info{} {}
+
+vassal::irc::message_view::message_view(const std::string_view raw_message)
+    : m_buffer{}, m_raw_message{raw_message}, m_tokens{},
+      m_type{message::type::standard}, m_command{irc::command::unknown},
+      m_sender_info{} {
+  parse();
+}
+
+vassal::irc::message_view::message_view(receive_buffer_ref buffer,
+                                        const std::string_view raw_message)
+    : m_buffer{std::move(buffer)}, m_raw_message{raw_message}, m_tokens{},
+      m_type{message::type::standard}, m_command{irc::command::unknown},
+      m_sender_info{} {
+  parse();
+}
+
+vassal::irc::message_view::message_view(const message_view &other)
+    : m_buffer{other.m_buffer}, m_raw_message{other.m_raw_message},
+      m_tokens{other.m_tokens}, m_type{other.m_type},
+      m_command{other.m_command}, m_sender_info{other.m_sender_info} {}
+
+vassal::irc::message_view::message_view(message_view &&other) noexcept
+    : m_buffer{std::move(other.m_buffer)}, m_raw_message{other.m_raw_message},
+      m_tokens{other.m_tokens}, m_type{other.m_type},
+      m_command{other.m_command}, m_sender_info{other.m_sender_info} {}
+
+vassal::irc::message_view::~message_view() {}
+
+vassal::irc::message::type vassal::irc::message_view::get_type() const {
+  return m_type;
+}
+
+std::string_view vassal::irc::message_view::get_keyword() const {
+  return m_tokens.command;
+}
+
+vassal::irc::command vassal::irc::message_view::get_command() const {
+  return m_command;
+}
+
+vassal::irc::message_view::sender_info
+vassal::irc::message_view::get_sender_info() const {
+  return m_sender_info;
+}
+
+std::string_view vassal::irc::message_view::get_tags() const {
+  return m_tokens.tags;
+}
+
+std::string_view
+vassal::irc::message_view::get_tag(const std::string_view key) const {
+  // values are returned still escaped; a key without a value reads as empty
+  std::string_view tags{m_tokens.tags};
+
+  while (tags.empty() == false) {
+    const std::size_t tag_end{std::min(tags.find(';'), tags.size())};
+    const std::string_view tag{tags.substr(0, tag_end)};
+    const std::size_t equals{tag.find('=')};
+
+    if (tag.substr(0, equals) == key) {
+      return ((equals == std::string_view::npos) ? std::string_view{}
+                                                 : tag.substr(equals + 1));
+    }
+
+    tags.remove_prefix(std::min((tag_end + 1), tags.size()));
+  }
+
+  return std::string_view{};
+}
+
+std::span<const std::string_view>
+vassal::irc::message_view::get_params() const {
+  return m_tokens.get_params();
+}
+
+std::string_view
+vassal::irc::message_view::get_param(const std::size_t index) const {
+  return ((index < m_tokens.param_count) ? m_tokens.params[index]
+                                         : std::string_view{});
+}
+
+std::string_view vassal::irc::message_view::get_recipient() const {
+  return get_param(0);
+}
+
+std::string_view vassal::irc::message_view::get_body() const {
+  return ((m_tokens.param_count > 1)
+              ? m_tokens.params[m_tokens.param_count - 1]
+              : std::string_view{});
+}
+
+std::string_view vassal::irc::message_view::get_raw_message() const {
+  return m_raw_message;
+}
+
+const vassal::irc::message_tokens &
+vassal::irc::message_view::get_tokens() const {
+  return m_tokens;
+}
+
+vassal::irc::message *vassal::irc::message_view::to_message() const {
+  switch (m_type) {
+  case message::type::standard:
+    return new standard_message{*this};
+    break;
+  case message::type::numeric:
+    return new numeric_message{*this};
+    break;
+  }
+
+  return nullptr;
+}
+
+vassal::irc::message *
+vassal::irc::message_view::to_message(message_slab &slab) const {
+  switch (m_type) {
+  case message::type::standard:
+    return new (slab) standard_message{*this};
+    break;
+  case message::type::numeric:
+    return new (slab) numeric_message{*this};
+    break;
+  }
+
+  return nullptr;
+}
+
+vassal::irc::any_message vassal::irc::message_view::to_any_message() const {
+  switch (m_type) {
+  case message::type::standard:
+    return any_message{std::in_place_type<standard_message>, *this};
+    break;
+  case message::type::numeric:
+    return any_message{std::in_place_type<numeric_message>, *this};
+    break;
+  }
+
+  return any_message{};
+}
+
+vassal::irc::message_view &
+vassal::irc::message_view::operator=(const message_view &other) {
+  m_buffer = other.m_buffer;
+  m_raw_message = other.m_raw_message;
+  m_tokens = other.m_tokens;
+  m_type = other.m_type;
+  m_command = other.m_command;
+  m_sender_info = other.m_sender_info;
+
+  return *this;
+}
+
+vassal::irc::message_view &
+vassal::irc::message_view::operator=(message_view &&other) noexcept {
+  m_buffer = std::move(other.m_buffer);
+  m_raw_message = other.m_raw_message;
+  m_tokens = other.m_tokens;
+  m_type = other.m_type;
+  m_command = other.m_command;
+  m_sender_info = other.m_sender_info;
+
+  return *this;
+}
+
+void vassal::irc::message_view::parse() {
+  m_tokens = tokenize(m_raw_message);
+  m_type = ((m_tokens.is_numeric() == true) ? message::type::numeric
+                                            : message::type::standard);
+  m_command = ((m_type == message::type::standard)
+                   ? commands::lookup(m_tokens.command)
+                   : irc::command::unknown);
+  parse_sender_info();
+}
+
+void vassal::irc::message_view::parse_sender_info() {
+  static constexpr char k_delimiter_exclamation_mark{'!'};
+  static constexpr char k_delimiter_at_sign{'@'};
+
+  const std::string_view prefix{m_tokens.prefix};
+
+  const std::string_view::size_type pos_exclamation_mark{
+      prefix.find(k_delimiter_exclamation_mark)};
+  const std::string_view::size_type pos_at_sign{
+      prefix.find(k_delimiter_at_sign)};
+
+  if ((pos_exclamation_mark == std::string_view::npos) &&
+      (pos_at_sign == std::string_view::npos)) {
+    m_sender_info.sender_nick = "";
+    m_sender_info.sender_user = "";
+    m_sender_info.sender_host = prefix;
+  } else if (pos_exclamation_mark == std::string_view::npos) {
+    m_sender_info.sender_nick = prefix.substr(0, pos_at_sign);
+    m_sender_info.sender_user = "";
+    m_sender_info.sender_host = prefix.substr(pos_at_sign + 1);
+  } else {
+    m_sender_info.sender_nick = prefix.substr(0, pos_exclamation_mark);
+    m_sender_info.sender_user = prefix.substr(
+        (pos_exclamation_mark + 1), (pos_at_sign - (pos_exclamation_mark + 1)));
+    m_sender_info.sender_host =
+        ((pos_at_sign == std::string_view::npos)
+             ? std::string_view{}
+             : prefix.substr(pos_at_sign + 1));
+  }
+}
+
+std::ostream &vassal::irc::operator<<(std::ostream &out,
+                                      const message_view &m) {
+  out << m.m_raw_message;
+  return out;
+}
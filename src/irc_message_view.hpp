@@ -0,0 +1,80 @@
+#ifndef VASSAL_IRC_MESSAGE_VIEW_HPP
+#define VASSAL_IRC_MESSAGE_VIEW_HPP
+
+#include "irc_any_message.hpp"
+#include "irc_commands.hpp"
+#include "irc_message.hpp"
+#include "irc_message_slab.hpp"
+#include "irc_receive_buffer.hpp"
+#include "irc_tokenizer.hpp"
+
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <string_view>
+
+namespace vassal {
+
+namespace irc {
+// Non-owning parse of a single message. All fields point into the raw line,
+// which is kept alive by the receive buffer reference (if any).
+class message_view {
+public:
+  struct sender_info {
+    std::string_view sender_nick;
+    std::string_view sender_user;
+    std::string_view sender_host;
+  };
+
+private:
+  receive_buffer_ref m_buffer;
+  std::string_view m_raw_message;
+  message_tokens m_tokens;
+  message::type m_type;
+  irc::command m_command;
+  sender_info m_sender_info;
+
+public:
+  message_view();
+  explicit message_view(const std::string_view raw_message);
+  message_view(receive_buffer_ref buffer, const std::string_view raw_message);
+  message_view(const message_view &other);
+  message_view(message_view &&other) noexcept;
+
+  ~message_view();
+
+public:
+  message::type get_type() const;
+  std::string_view get_keyword() const;
+  irc::command get_command() const;
+  sender_info get_sender_info() const;
+  std::string_view get_tags() const;
+  std::string_view get_tag(const std::string_view key) const;
+  std::span<const std::string_view> get_params() const;
+  std::string_view get_param(const std::size_t index) const;
+  std::string_view get_recipient() const;
+  std::string_view get_body() const;
+  std::string_view get_raw_message() const;
+  const message_tokens &get_tokens() const;
+
+  message *to_message() const;
+  message *to_message(message_slab &slab) const;
+  any_message to_any_message() const;
+
+public:
+  message_view &operator=(const message_view &other);
+  message_view &operator=(message_view &&other) noexcept;
+
+public:
+  friend std::ostream &operator<<(std::ostream &out, const message_view &m);
+
+private:
+  void parse();
+  void parse_sender_info();
+};
+
+std::ostream &operator<<(std::ostream &out, const message_view &m);
+} // namespace irc
+
+} // namespace vassal
+#endif
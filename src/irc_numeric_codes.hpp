@@ -0,0 +1,300 @@
+#ifndef VASSAL_IRC_NUMERIC_CODES_HPP
+#define VASSAL_IRC_NUMERIC_CODES_HPP
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace vassal {
+
+namespace irc {
+namespace numeric_codes {
+struct code_name {
+  int code;
+  std::string_view name;
+};
+
+struct code_info {
+  std::string_view name;
+  bool is_known;
+  bool is_client_only;
+  bool is_command_reply;
+  bool is_error;
+};
+
+inline constexpr int k_code_count{1000};
+
+inline constexpr int k_client_only_range_start{1};
+inline constexpr int k_client_only_range_end{99};
+inline constexpr int k_command_reply_range_start{200};
+inline constexpr int k_command_reply_range_end{399};
+inline constexpr int k_error_range_start{400};
+inline constexpr int k_error_range_end{599};
+
+inline constexpr std::array k_code_names{
+    code_name{1, "RPL_WELCOME"},
+    code_name{2, "RPL_YOURHOST"},
+    code_name{3, "RPL_CREATED"},
+    code_name{4, "RPL_MYINFO"},
+    code_name{5, "RPL_BOUNCE"},
+    code_name{200, "RPL_TRACELINK"},
+    code_name{201, "RPL_TRACECONNECTING"},
+    code_name{202, "RPL_TRACEHANDSHAKE"},
+    code_name{203, "RPL_TRACEUNKNOWN"},
+    code_name{204, "RPL_TRACEOPERATOR"},
+    code_name{205, "RPL_TRACEUSER"},
+    code_name{206, "RPL_TRACESERVER"},
+    code_name{207, "RPL_TRACESERVICE"},
+    code_name{208, "RPL_TRACENEWTYPE"},
+    code_name{209, "RPL_TRACECLASS"},
+    code_name{210, "RPL_TRACERECONNECT"},
+    code_name{211, "RPL_STATSLINKINFO"},
+    code_name{212, "RPL_STATSCOMMANDS"},
+    code_name{213, "RPL_STATSCLINE"},
+    code_name{214, "RPL_STATSNLINE"},
+    code_name{215, "RPL_STATSILINE"},
+    code_name{216, "RPL_STATSKLINE"},
+    code_name{217, "RPL_STATSQLINE"},
+    code_name{218, "RPL_STATSYLINE"},
+    code_name{219, "RPL_ENDOFSTATS"},
+    code_name{221, "RPL_UMODEIS"},
+    code_name{231, "RPL_SERVICEINFO"},
+    code_name{232, "RPL_ENDOFSERVICES"},
+    code_name{233, "RPL_SERVICE"},
+    code_name{234, "RPL_SERVLIST"},
+    code_name{235, "RPL_SERVLISTEND"},
+    code_name{240, "RPL_STATSVLINE"},
+    code_name{241, "RPL_STATSLLINE"},
+    code_name{242, "RPL_STATSUPTIME"},
+    code_name{243, "RPL_STATSOLINE"},
+    code_name{244, "RPL_STATSHLINE"},
+    code_name{245, "RPL_STATSSLINE"},
+    code_name{246, "RPL_STATSPING"},
+    code_name{247, "RPL_STATSBLINE"},
+    code_name{250, "RPL_STATSDLINE"},
+    code_name{251, "RPL_LUSERCLIENT"},
+    code_name{252, "RPL_LUSEROP"},
+    code_name{253, "RPL_LUSERUNKNOWN"},
+    code_name{254, "RPL_LUSERCHANNELS"},
+    code_name{255, "RPL_LUSERME"},
+    code_name{256, "RPL_ADMINME"},
+    code_name{257, "RPL_ADMINLOC1"},
+    code_name{258, "RPL_ADMINLOC2"},
+    code_name{259, "RPL_ADMINEMAIL"},
+    code_name{261, "RPL_TRACELOG"},
+    code_name{262, "RPL_TRACEEND"},
+    code_name{263, "RPL_TRYAGAIN"},
+    code_name{300, "RPL_NONE"},
+    code_name{301, "RPL_AWAY"},
+    code_name{302, "RPL_USERHOST"},
+    code_name{303, "RPL_ISON"},
+    code_name{305, "RPL_UNAWAY"},
+    code_name{306, "RPL_NOWAWAY"},
+    code_name{311, "RPL_WHOISUSER"},
+    code_name{312, "RPL_WHOISSERVER"},
+    code_name{313, "RPL_WHOISOPERATOR"},
+    code_name{314, "RPL_WHOWASUSER"},
+    code_name{315, "RPL_ENDOFWHO"},
+    code_name{316, "RPL_WHOISCHANOP"},
+    code_name{317, "RPL_WHOISIDLE"},
+    code_name{318, "RPL_ENDOFWHOIS"},
+    code_name{319, "RPL_WHOISCHANNELS"},
+    code_name{321, "RPL_LISTSTART"},
+    code_name{322, "RPL_LIST"},
+    code_name{323, "RPL_LISTEND"},
+    code_name{324, "RPL_CHANNELMODEIS"},
+    code_name{325, "RPL_UNIQOPIS"},
+    code_name{331, "RPL_NOTOPIC"},
+    code_name{332, "RPL_TOPIC"},
+    code_name{341, "RPL_INVITING"},
+    code_name{342, "RPL_SUMMONING"},
+    code_name{346, "RPL_INVITELIST"},
+    code_name{347, "RPL_ENDOFINVITELIST"},
+    code_name{348, "RPL_EXCEPTLIST"},
+    code_name{349, "RPL_ENDOFEXCEPTLIST"},
+    code_name{351, "RPL_VERSION"},
+    code_name{352, "RPL_WHOREPLY"},
+    code_name{353, "RPL_NAMREPLY"},
+    code_name{361, "RPL_KILLDONE"},
+    code_name{362, "RPL_CLOSING"},
+    code_name{363, "RPL_CLOSEEND"},
+    code_name{364, "RPL_LINKS"},
+    code_name{365, "RPL_ENDOFLINKS"},
+    code_name{366, "RPL_ENDOFNAMES"},
+    code_name{367, "RPL_BANLIST"},
+    code_name{368, "RPL_ENDOFBANLIST"},
+    code_name{369, "RPL_ENDOFWHOWAS"},
+    code_name{371, "RPL_INFO"},
+    code_name{372, "RPL_MOTD"},
+    code_name{373, "RPL_INFOSTART"},
+    code_name{374, "RPL_ENDOFINFO"},
+    code_name{375, "RPL_MOTDSTART"},
+    code_name{376, "RPL_ENDOFMOTD"},
+    code_name{381, "RPL_YOUREOPER"},
+    code_name{382, "RPL_REHASHING"},
+    code_name{383, "RPL_YOURESERVICE"},
+    code_name{384, "RPL_MYPORTIS"},
+    code_name{391, "RPL_TIME"},
+    code_name{392, "RPL_USERSSTART"},
+    code_name{393, "RPL_USERS"},
+    code_name{394, "RPL_ENDOFUSERS"},
+    code_name{395, "RPL_NOUSERS"},
+    code_name{401, "ERR_NOSUCHNICK"},
+    code_name{402, "ERR_NOSUCHSERVER"},
+    code_name{403, "ERR_NOSUCHCHANNEL"},
+    code_name{404, "ERR_CANNOTSENDTOCHAN"},
+    code_name{405, "ERR_TOOMANYCHANNELS"},
+    code_name{406, "ERR_WASNOSUCHNICK"},
+    code_name{407, "ERR_TOOMANYTARGETS"},
+    code_name{408, "ERR_NOSUCHSERVICE"},
+    code_name{409, "ERR_NOORIGIN"},
+    code_name{411, "ERR_NORECIPIENT"},
+    code_name{412, "ERR_NOTEXTTOSEND"},
+    code_name{413, "ERR_NOTOPLEVEL"},
+    code_name{414, "ERR_WILDTOPLEVEL"},
+    code_name{415, "ERR_BADMASK"},
+    code_name{421, "ERR_UNKNOWNCOMMAND"},
+    code_name{422, "ERR_NOMOTD"},
+    code_name{423, "ERR_NOADMININFO"},
+    code_name{424, "ERR_FILEERROR"},
+    code_name{431, "ERR_NONICKNAMEGIVEN"},
+    code_name{432, "ERR_ERRONEUSNICKNAME"},
+    code_name{433, "ERR_NICKNAMEINUSE"},
+    code_name{436, "ERR_NICKCOLLISION"},
+    code_name{437, "ERR_UNAVAILRESOURCE"},
+    code_name{441, "ERR_USERNOTINCHANNEL"},
+    code_name{442, "ERR_NOTONCHANNEL"},
+    code_name{443, "ERR_USERONCHANNEL"},
+    code_name{444, "ERR_NOLOGIN"},
+    code_name{445, "ERR_SUMMONDISABLED"},
+    code_name{446, "ERR_USERSDISABLED"},
+    code_name{451, "ERR_NOTREGISTERED"},
+    code_name{461, "ERR_NEEDMOREPARAMS"},
+    code_name{462, "ERR_ALREADYREGISTRED"},
+    code_name{463, "ERR_NOPERMFORHOST"},
+    code_name{464, "ERR_PASSWDMISMATCH"},
+    code_name{465, "ERR_YOUREBANNEDCREEP"},
+    code_name{466, "ERR_YOUWILLBEBANNED"},
+    code_name{467, "ERR_KEYSET"},
+    code_name{471, "ERR_CHANNELISFULL"},
+    code_name{472, "ERR_UNKNOWNMODE"},
+    code_name{473, "ERR_INVITEONLYCHAN"},
+    code_name{474, "ERR_BANNEDFROMCHAN"},
+    code_name{475, "ERR_BADCHANNELKEY"},
+    code_name{476, "ERR_BADCHANMASK"},
+    code_name{477, "ERR_NOCHANMODES"},
+    code_name{478, "ERR_BANLISTFULL"},
+    code_name{481, "ERR_NOPRIVILEGES"},
+    code_name{482, "ERR_CHANOPRIVSNEEDED"},
+    code_name{483, "ERR_CANTKILLSERVER"},
+    code_name{484, "ERR_RESTRICTED"},
+    code_name{485, "ERR_UNIQOPPRIVSNEEDED"},
+    code_name{491, "ERR_NOOPERHOST"},
+    code_name{492, "ERR_NOSERVICEHOST"},
+    code_name{501, "ERR_UMODEUNKNOWNFLAG"},
+    code_name{502, "ERR_USERSDONTMATCH"},
+};
+
+consteval bool check_code_names() {
+  for (std::size_t i{0}; i < k_code_names.size(); ++i) {
+    const int code{k_code_names[i].code};
+
+    if ((code < 0) || (code >= k_code_count)) {
+      return false;
+    }
+    if ((i > 0) && (code <= k_code_names[i - 1].code)) {
+      return false;
+    }
+    if (k_code_names[i].name.empty() == true) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+consteval bool check_code_categories() {
+  for (const code_name &entry : k_code_names) {
+    const bool is_client_only{(entry.code >= k_client_only_range_start) &&
+                              (entry.code <= k_client_only_range_end)};
+    const bool is_command_reply{(entry.code >= k_command_reply_range_start) &&
+                                (entry.code <= k_command_reply_range_end)};
+    const bool is_error{(entry.code >= k_error_range_start) &&
+                        (entry.code <= k_error_range_end)};
+
+    if ((is_client_only == false) && (is_command_reply == false) &&
+        (is_error == false)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static_assert(check_code_names() == true,
+              "numeric codes must be in [0, 999], strictly increasing (no "
+              "duplicates) and named");
+static_assert(check_code_categories() == true,
+              "every named numeric code must fall into a reply category");
+
+consteval std::array<code_info, k_code_count> make_code_table() {
+  std::array<code_info, k_code_count> table{};
+
+  for (int code{0}; code < k_code_count; ++code) {
+    table[code] = code_info{
+        "",
+        false,
+        ((code >= k_client_only_range_start) &&
+         (code <= k_client_only_range_end)),
+        ((code >= k_command_reply_range_start) &&
+         (code <= k_command_reply_range_end)),
+        ((code >= k_error_range_start) && (code <= k_error_range_end)),
+    };
+  }
+
+  for (const code_name &entry : k_code_names) {
+    table[entry.code].name = entry.name;
+    table[entry.code].is_known = true;
+  }
+
+  return table;
+}
+
+inline constexpr std::array<code_info, k_code_count> k_code_table{
+    make_code_table()};
+
+constexpr const code_info &lookup(const int code) {
+  return (((code >= 0) && (code < k_code_count)) ? k_code_table[code]
+                                                 : k_code_table[0]);
+}
+
+// returns -1 unless keyword is exactly three digits
+constexpr int parse_code(const std::string_view keyword) {
+  if (keyword.size() != 3) {
+    return -1;
+  }
+
+  int code{0};
+  for (const char c : keyword) {
+    if ((c < '0') || (c > '9')) {
+      return -1;
+    }
+    code = (code * 10) + (c - '0');
+  }
+
+  return code;
+}
+
+static_assert(lookup(1).name == "RPL_WELCOME");
+static_assert(lookup(245).name == "RPL_STATSSLINE");
+static_assert((lookup(433).is_known == true) && (lookup(433).is_error == true));
+static_assert(lookup(999).is_known == false);
+static_assert(parse_code("001") == 1);
+static_assert(parse_code("433") == 433);
+static_assert(parse_code("43") == -1);
+static_assert(parse_code("PING") == -1);
+} // namespace numeric_codes
+} // namespace irc
+
+} // namespace vassal
+#endif
@@ -2,17 +2,17 @@
 #define VASSAL_IRC_NUMERIC_MESSAGE_HPP
 
 #include "irc_message.hpp"
+#include "irc_numeric_codes.hpp"
 
 #include <iostream>
 #include <string>
 #include <string_view>
 #include <type_traits>
-#include <unordered_map>
 
 namespace vassal {
 
 namespace irc {
-class numeric_message : public message {
+class numeric_message final : public message {
 public:
   enum class unknown_code_policy {
     relaxed,
@@ -21,19 +21,19 @@ public:
 
 private:
   int m_code;
-  std::string m_code_string;
+  std::string_view m_code_string;
   bool m_is_error;
   unknown_code_policy m_unknown_code_policy;
   bool m_is_code_known;
 
-private:
-  static const std::unordered_map<int, std::string> m_k_code_string_hash_table;
-
 public:
   numeric_message();
   explicit numeric_message(const std::string_view raw_message,
                            const unknown_code_policy unknown_code_policy =
                                unknown_code_policy::relaxed);
+  explicit numeric_message(const message_view &view,
+                           const unknown_code_policy unknown_code_policy =
+                               unknown_code_policy::relaxed);
   numeric_message(const numeric_message &other);
   numeric_message(numeric_message &&other) noexcept;
 
@@ -47,7 +47,8 @@ public:
   virtual std::string get_keyword() const override;
 
   int get_code() const;
-  std::string get_code_string() const;
+  std::string_view get_code_string() const;
+  const numeric_codes::code_info &get_code_info() const;
   bool get_is_error() const;
   unknown_code_policy get_unknown_code_policy() const;
   bool get_is_code_known() const;
@@ -55,14 +56,13 @@ public:
 public:
   numeric_message &operator=(const numeric_message &other);
   numeric_message &operator=(numeric_message &&other) noexcept(
-      std::is_nothrow_move_assignable_v<message>
-          &&std::is_nothrow_move_assignable_v<std::string>);
+      std::is_nothrow_move_assignable_v<message>);
 
 protected:
   virtual void print(std::ostream &out) const override;
 
 private:
-  void parse_code(const std::string_view raw_message);
+  void parse_code(const std::string_view code_substr);
 };
 } // namespace irc
 
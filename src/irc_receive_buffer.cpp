@@ -0,0 +1,221 @@
+#include "irc_receive_buffer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+vassal::irc::receive_buffer::receive_buffer(
+    const std::size_t capacity, std::shared_ptr<pool_state> pool_state)
+    : m_data{new char[capacity]}, m_capacity{capacity}, m_size{0},
+      m_ref_count{0}, m_pool_state{std::move(pool_state)} {
+  m_pool_state->allocated_bytes.fetch_add(m_capacity,
+                                          std::memory_order_relaxed);
+}
+
+vassal::irc::receive_buffer::~receive_buffer() {
+  m_pool_state->allocated_bytes.fetch_sub(m_capacity,
+                                          std::memory_order_relaxed);
+}
+
+const char *vassal::irc::receive_buffer::get_data() const {
+  return m_data.get();
+}
+
+std::size_t vassal::irc::receive_buffer::get_size() const { return m_size; }
+
+std::size_t vassal::irc::receive_buffer::get_capacity() const {
+  return m_capacity;
+}
+
+std::size_t vassal::irc::receive_buffer::get_free_space() const {
+  return (m_capacity - m_size);
+}
+
+std::string_view
+vassal::irc::receive_buffer::get_view(const std::size_t pos,
+                                      const std::size_t count) const {
+  return std::string_view{(m_data.get() + pos), count};
+}
+
+char *vassal::irc::receive_buffer::get_free_data() {
+  return (m_data.get() + m_size);
+}
+
+void vassal::irc::receive_buffer::commit(const std::size_t count) {
+  if (count > get_free_space()) {
+    throw std::runtime_error{"receive buffer overflow"};
+  }
+
+  m_size += count;
+}
+
+void vassal::irc::receive_buffer::append(const std::string_view data) {
+  if (data.size() > get_free_space()) {
+    throw std::runtime_error{"receive buffer overflow"};
+  }
+
+  std::memcpy(get_free_data(), data.data(), data.size());
+  m_size += data.size();
+}
+
+void vassal::irc::receive_buffer::release() {
+  if (m_ref_count.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+
+  bool recycled{false};
+  {
+    std::unique_lock<std::mutex> pool_state_mutex_lock{m_pool_state->mutex};
+
+    if ((m_pool_state->closed == false) &&
+        (m_capacity == m_pool_state->buffer_capacity)) {
+      m_size = 0;
+      m_pool_state->free_buffers.push_back(this);
+      recycled = true;
+    }
+  }
+
+  if (recycled == false) {
+    delete this;
+  }
+}
+
+vassal::irc::receive_buffer_ref::receive_buffer_ref() : m_buffer{nullptr} {}
+
+vassal::irc::receive_buffer_ref::receive_buffer_ref(receive_buffer *buffer)
+    : m_buffer{buffer} {
+  if (m_buffer != nullptr) {
+    m_buffer->m_ref_count.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+vassal::irc::receive_buffer_ref::receive_buffer_ref(
+    const receive_buffer_ref &other)
+    : receive_buffer_ref{other.m_buffer} {}
+
+vassal::irc::receive_buffer_ref::receive_buffer_ref(
+    receive_buffer_ref &&other) noexcept
+    : m_buffer{std::exchange(other.m_buffer, nullptr)} {}
+
+vassal::irc::receive_buffer_ref::~receive_buffer_ref() {
+  if (m_buffer != nullptr) {
+    m_buffer->release();
+    m_buffer = nullptr;
+  }
+}
+
+vassal::irc::receive_buffer *vassal::irc::receive_buffer_ref::get() const {
+  return m_buffer;
+}
+
+vassal::irc::receive_buffer_ref &
+vassal::irc::receive_buffer_ref::operator=(const receive_buffer_ref &other) {
+  if (this == &other) {
+    return *this;
+  }
+
+  receive_buffer_ref temp{other};
+  std::swap(m_buffer, temp.m_buffer);
+
+  return *this;
+}
+
+vassal::irc::receive_buffer_ref &
+vassal::irc::receive_buffer_ref::operator=(
+    receive_buffer_ref &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+
+  receive_buffer_ref temp{std::move(other)};
+  std::swap(m_buffer, temp.m_buffer);
+
+  return *this;
+}
+
+vassal::irc::receive_buffer *
+vassal::irc::receive_buffer_ref::operator->() const {
+  return m_buffer;
+}
+
+vassal::irc::receive_buffer_ref::operator bool() const {
+  return (m_buffer != nullptr);
+}
+
+vassal::irc::receive_buffer_pool::receive_buffer_pool(
+    const std::size_t buffer_capacity /*= m_k_default_buffer_capacity*/)
+    : m_state{std::make_shared<receive_buffer::pool_state>()} {
+  m_state->buffer_capacity = buffer_capacity;
+  m_state->allocated_bytes = 0;
+  m_state->closed = false;
+}
+
+vassal::irc::receive_buffer_pool::receive_buffer_pool(
+    receive_buffer_pool &&other) noexcept
+    : m_state{std::move(other.m_state)} {}
+
+vassal::irc::receive_buffer_pool::~receive_buffer_pool() { close(); }
+
+vassal::irc::receive_buffer_ref
+vassal::irc::receive_buffer_pool::acquire(const std::size_t min_capacity
+                                          /*= 0*/) {
+  if (min_capacity <= m_state->buffer_capacity) {
+    std::unique_lock<std::mutex> state_mutex_lock{m_state->mutex};
+
+    if (m_state->free_buffers.empty() == false) {
+      receive_buffer *buffer{m_state->free_buffers.back()};
+      m_state->free_buffers.pop_back();
+      return receive_buffer_ref{buffer};
+    }
+  }
+
+  return receive_buffer_ref{new receive_buffer{
+      std::max(min_capacity, m_state->buffer_capacity), m_state}};
+}
+
+std::size_t vassal::irc::receive_buffer_pool::get_allocated_bytes() const {
+  return ((m_state == nullptr)
+              ? 0
+              : m_state->allocated_bytes.load(std::memory_order_relaxed));
+}
+
+vassal::irc::receive_buffer_pool &
+vassal::irc::receive_buffer_pool::operator=(
+    receive_buffer_pool &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+
+  close();
+  m_state = std::move(other.m_state);
+
+  return *this;
+}
+
+void vassal::irc::receive_buffer_pool::close() {
+  if (m_state == nullptr) {
+    return;
+  }
+
+  std::vector<receive_buffer *> free_buffers{};
+  {
+    std::unique_lock<std::mutex> state_mutex_lock{m_state->mutex};
+    m_state->closed = true;
+    free_buffers.swap(m_state->free_buffers);
+  }
+
+  for (size_t i{0}; i < free_buffers.size(); ++i) {
+    delete free_buffers[i];
+    free_buffers[i] = nullptr;
+  }
+
+  m_state = nullptr;
+}
@@ -0,0 +1,125 @@
+#ifndef VASSAL_IRC_RECEIVE_BUFFER_HPP
+#define VASSAL_IRC_RECEIVE_BUFFER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace vassal {
+
+namespace irc {
+class receive_buffer_pool;
+class receive_buffer_ref;
+
+// Fixed-capacity block of received bytes. Parsed message views point into
+// it; it is handed back to its pool once the last receive_buffer_ref to it
+// goes away.
+class receive_buffer {
+  friend class receive_buffer_pool;
+  friend class receive_buffer_ref;
+
+private:
+  struct pool_state {
+    std::mutex mutex;
+    std::vector<receive_buffer *> free_buffers;
+    std::size_t buffer_capacity;
+    std::atomic<std::size_t> allocated_bytes;
+    bool closed;
+  };
+
+private:
+  std::unique_ptr<char[]> m_data;
+  std::size_t m_capacity;
+  std::size_t m_size;
+  std::atomic<std::size_t> m_ref_count;
+  std::shared_ptr<pool_state> m_pool_state;
+
+private:
+  receive_buffer(const std::size_t capacity,
+                 std::shared_ptr<pool_state> pool_state);
+
+public:
+  receive_buffer(const receive_buffer &other) = delete;
+  receive_buffer(receive_buffer &&other) = delete;
+
+  ~receive_buffer();
+
+public:
+  const char *get_data() const;
+  std::size_t get_size() const;
+  std::size_t get_capacity() const;
+  std::size_t get_free_space() const;
+
+  std::string_view get_view(const std::size_t pos,
+                            const std::size_t count) const;
+
+  char *get_free_data();
+  void commit(const std::size_t count);
+  void append(const std::string_view data);
+
+public:
+  receive_buffer &operator=(const receive_buffer &other) = delete;
+  receive_buffer &operator=(receive_buffer &&other) = delete;
+
+private:
+  void release();
+};
+
+class receive_buffer_ref {
+private:
+  receive_buffer *m_buffer;
+
+public:
+  receive_buffer_ref();
+  explicit receive_buffer_ref(receive_buffer *buffer);
+  receive_buffer_ref(const receive_buffer_ref &other);
+  receive_buffer_ref(receive_buffer_ref &&other) noexcept;
+
+  ~receive_buffer_ref();
+
+public:
+  receive_buffer *get() const;
+
+public:
+  receive_buffer_ref &operator=(const receive_buffer_ref &other);
+  receive_buffer_ref &operator=(receive_buffer_ref &&other) noexcept;
+
+  receive_buffer *operator->() const;
+  explicit operator bool() const;
+};
+
+class receive_buffer_pool {
+private:
+  std::shared_ptr<receive_buffer::pool_state> m_state;
+
+private:
+  static constexpr std::size_t m_k_default_buffer_capacity{65536};
+
+public:
+  explicit receive_buffer_pool(
+      const std::size_t buffer_capacity = m_k_default_buffer_capacity);
+  receive_buffer_pool(receive_buffer_pool &&other) noexcept;
+
+  receive_buffer_pool(const receive_buffer_pool &other) = delete;
+
+  ~receive_buffer_pool();
+
+public:
+  receive_buffer_ref acquire(const std::size_t min_capacity = 0);
+  std::size_t get_allocated_bytes() const;
+
+public:
+  receive_buffer_pool &operator=(receive_buffer_pool &&other) noexcept;
+
+  receive_buffer_pool &operator=(const receive_buffer_pool &other) = delete;
+
+private:
+  void close();
+};
+} // namespace irc
+
+} // namespace vassal
+#endif
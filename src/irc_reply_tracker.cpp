@@ -0,0 +1,514 @@
+#include "irc_reply_tracker.hpp"
+
+#include "irc_commands.hpp"
+#include "irc_message_view.hpp"
+#include "irc_numeric_codes.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+struct reply_spec {
+  std::span<const int> replies;
+  std::span<const int> ends;
+  std::span<const int> terminals;
+};
+
+constexpr std::array k_whois_replies{276, 301, 307, 311, 312, 313, 317, 319,
+                                     320, 330, 338, 378, 379, 401, 671};
+constexpr std::array k_whois_ends{318};
+constexpr std::array k_whois_terminals{402, 431};
+
+constexpr std::array k_names_replies{353};
+constexpr std::array k_names_ends{366};
+
+constexpr std::array k_list_replies{321, 322};
+constexpr std::array k_list_ends{323};
+
+constexpr std::array k_who_replies{352, 354};
+constexpr std::array k_who_ends{315};
+
+constexpr std::array k_stats_replies{211, 212, 213, 214, 215, 216, 217,
+                                     218, 240, 241, 242, 243, 244, 245,
+                                     246, 247, 248, 249, 250, 481};
+constexpr std::array k_stats_ends{219};
+
+constexpr std::array<int, 0> k_no_terminals{};
+constexpr std::array k_server_terminals{402};
+
+// unknown command and missing parameters end a query when they name its
+// command
+constexpr std::array k_command_terminals{421, 461};
+
+// no such nick and no such server answer any command naming that nick or
+// server, so they only belong to a query that named it too
+constexpr std::array k_targeted_errors{401, 402};
+
+// no privileges names nothing at all
+constexpr int k_no_privileges{481};
+
+constexpr std::array<
+    reply_spec,
+    static_cast<std::size_t>(vassal::irc::reply_tracker::query_kind::N)>
+    k_reply_specs{
+        reply_spec{k_whois_replies, k_whois_ends, k_whois_terminals},
+        reply_spec{k_names_replies, k_names_ends, k_no_terminals},
+        reply_spec{k_list_replies, k_list_ends, k_server_terminals},
+        reply_spec{k_who_replies, k_who_ends, k_no_terminals},
+        reply_spec{k_stats_replies, k_stats_ends, k_server_terminals},
+    };
+
+constexpr std::array<
+    vassal::irc::command,
+    static_cast<std::size_t>(vassal::irc::reply_tracker::query_kind::N)>
+    k_query_commands{vassal::irc::command::whois, vassal::irc::command::names,
+                     vassal::irc::command::list, vassal::irc::command::who,
+                     vassal::irc::command::stats};
+
+constexpr std::string_view k_labeled_response{"labeled-response"};
+
+bool contains(const std::span<const int> codes, const int code) {
+  return (std::find(codes.begin(), codes.end(), code) != codes.end());
+}
+
+bool is_same_name(const std::string_view first,
+                  const std::string_view second) {
+  return std::equal(first.begin(), first.end(), second.begin(), second.end(),
+                    [](const char first_char, const char second_char) {
+                      return (std::tolower(static_cast<unsigned char>(
+                                  first_char)) ==
+                              std::tolower(static_cast<unsigned char>(
+                                  second_char)));
+                    });
+}
+
+// targets are the query's parameters, any of which may list several names
+// separated by commas
+bool is_target(std::string_view targets, const std::string_view name) {
+  while (targets.empty() == false) {
+    const std::size_t target_end{
+        std::min(targets.find_first_of(" ,"), targets.size())};
+    std::string_view target{targets.substr(0, target_end)};
+    if (target.starts_with(':') == true) {
+      target.remove_prefix(1);
+    }
+
+    if ((target.empty() == false) && (is_same_name(target, name) == true)) {
+      return true;
+    }
+
+    targets.remove_prefix(std::min((target_end + 1), targets.size()));
+  }
+
+  return false;
+}
+
+std::string_view get_targets(const std::string_view message) {
+  const std::size_t command_end{message.find(' ')};
+  return ((command_end == std::string_view::npos)
+              ? std::string_view{}
+              : message.substr(command_end + 1));
+}
+} // namespace
+
+vassal::irc::reply_tracker::reply_tracker()
+    : m_pending_queries{}, m_pending_queries_mutex{},
+      m_pending_query_count{0}, m_is_labeled_response_enabled{false},
+      m_next_label{0} {}
+
+vassal::irc::reply_tracker::~reply_tracker() { close(); }
+
+std::string vassal::irc::reply_tracker::make_label() {
+  if (m_is_labeled_response_enabled == false) {
+    return std::string{};
+  }
+
+  std::unique_lock<std::mutex> pending_queries_lock{m_pending_queries_mutex};
+  return std::to_string(++m_next_label);
+}
+
+std::future<vassal::irc::reply_tracker::reply>
+vassal::irc::reply_tracker::add(const query_kind kind, const std::string &label,
+                                const std::string_view message,
+                                const std::size_t end_count,
+                                const std::chrono::milliseconds timeout,
+                                row_callback on_row /*= row_callback{}*/) {
+  const std::chrono::steady_clock::time_point deadline{
+      (timeout == std::chrono::milliseconds::max())
+          ? std::chrono::steady_clock::time_point::max()
+          : (std::chrono::steady_clock::now() + timeout)};
+
+  std::unique_lock<std::mutex> pending_queries_lock{m_pending_queries_mutex};
+
+  m_pending_queries.push_back(pending_query{
+      kind, label, std::string{}, std::string{get_targets(message)},
+      std::max<std::size_t>(end_count, 1), deadline, std::promise<reply>{},
+      callback{},
+      (on_row) ? std::make_shared<row_callback>(std::move(on_row)) : nullptr,
+      reply{{}, false}, false});
+  ++m_pending_query_count;
+
+  return m_pending_queries.back().promise.get_future();
+}
+
+void vassal::irc::reply_tracker::add(const query_kind kind,
+                                     const std::string &label,
+                                     const std::string_view message,
+                                     const std::size_t end_count,
+                                     const std::chrono::milliseconds timeout,
+                                     callback on_reply) {
+  const std::chrono::steady_clock::time_point deadline{
+      (timeout == std::chrono::milliseconds::max())
+          ? std::chrono::steady_clock::time_point::max()
+          : (std::chrono::steady_clock::now() + timeout)};
+
+  std::unique_lock<std::mutex> pending_queries_lock{m_pending_queries_mutex};
+
+  m_pending_queries.push_back(pending_query{
+      kind, label, std::string{}, std::string{get_targets(message)},
+      std::max<std::size_t>(end_count, 1), deadline, std::promise<reply>{},
+      std::move(on_reply), nullptr, reply{{}, false}, false});
+  ++m_pending_query_count;
+}
+
+bool vassal::irc::reply_tracker::remove(const std::string &label) {
+  std::unique_lock<std::mutex> pending_queries_lock{m_pending_queries_mutex};
+
+  // the query being taken back is the newest one with its label, since the
+  // caller added it and couldn't send it
+  for (auto query{m_pending_queries.end()};
+       query != m_pending_queries.begin();) {
+    --query;
+    if (query->label != label) {
+      continue;
+    }
+
+    const bool is_resolved{query->is_expired};
+    m_pending_queries.erase(query);
+    --m_pending_query_count;
+
+    return (is_resolved == false);
+  }
+
+  return false;
+}
+
+bool vassal::irc::reply_tracker::is_interested(
+    const std::string_view command_token) const {
+  return ((m_pending_query_count.load(std::memory_order_relaxed) != 0) ||
+          (commands::lookup(command_token) == irc::command::cap));
+}
+
+bool vassal::irc::reply_tracker::handle(const message_view &message) {
+  if (message.get_command() == irc::command::cap) {
+    handle_capabilities(message);
+    return false;
+  }
+
+  if (m_pending_query_count.load(std::memory_order_relaxed) == 0) {
+    return false;
+  }
+
+  // callbacks run once the lock is released, since they may queue more
+  // queries
+  std::vector<completion> completions{};
+  const bool is_matched{match(message, completions)};
+  run(completions);
+
+  return is_matched;
+}
+
+bool vassal::irc::reply_tracker::match(const message_view &message,
+                                       std::vector<completion> &completions) {
+  std::unique_lock<std::mutex> pending_queries_lock{m_pending_queries_mutex};
+
+  const std::string_view label{message.get_tag("label")};
+  if (label.empty() == false) {
+    for (auto query{m_pending_queries.begin()};
+         query != m_pending_queries.end(); ++query) {
+      if (query->label != label) {
+        continue;
+      }
+
+      if ((message.get_command() == irc::command::batch) &&
+          (message.get_param(0).starts_with('+') == true)) {
+        query->batch = message.get_param(0).substr(1);
+        return true;
+      }
+
+      // a lone ACK means the query produced no output at all
+      if (message.get_keyword() != "ACK") {
+        collect(*query, message, completions);
+      }
+      complete(query, completions);
+      return true;
+    }
+
+    return false;
+  }
+
+  const std::string_view batch{message.get_tag("batch")};
+  const bool is_batch_end{(message.get_command() == irc::command::batch) &&
+                          (message.get_param(0).starts_with('-') == true)};
+  if ((batch.empty() == false) || (is_batch_end == true)) {
+    const std::string_view reference{
+        (is_batch_end == true) ? message.get_param(0).substr(1) : batch};
+
+    for (auto query{m_pending_queries.begin()};
+         query != m_pending_queries.end(); ++query) {
+      if ((query->batch.empty() == true) || (query->batch != reference)) {
+        continue;
+      }
+
+      if (is_batch_end == true) {
+        complete(query, completions);
+      } else {
+        collect(*query, message, completions);
+      }
+      return true;
+    }
+  }
+
+  const int numeric_code{numeric_codes::parse_code(message.get_keyword())};
+  if (numeric_code == -1) {
+    return false;
+  }
+
+  const auto oldest_unlabeled_query{
+      std::find_if(m_pending_queries.begin(), m_pending_queries.end(),
+                   [](const pending_query &query) {
+                     return (query.label.empty() == true);
+                   })};
+
+  for (auto query{m_pending_queries.begin()}; query != m_pending_queries.end();
+       ++query) {
+    if (query->label.empty() == false) {
+      continue;
+    }
+
+    const reply_spec &spec{
+        k_reply_specs[static_cast<std::size_t>(query->kind)]};
+    const bool is_end{contains(spec.ends, numeric_code)};
+    const bool is_terminal{
+        (contains(spec.terminals, numeric_code) == true) ||
+        ((contains(k_command_terminals, numeric_code) == true) &&
+         (commands::lookup(message.get_param(1)) ==
+          k_query_commands[static_cast<std::size_t>(query->kind)]))};
+
+    if ((is_end == false) && (is_terminal == false) &&
+        (contains(spec.replies, numeric_code) == false)) {
+      continue;
+    }
+
+    if ((contains(k_targeted_errors, numeric_code) == true) &&
+        (is_target(query->targets, message.get_param(1)) == false)) {
+      continue;
+    }
+
+    if ((numeric_code == k_no_privileges) &&
+        (query != oldest_unlabeled_query)) {
+      continue;
+    }
+
+    collect(*query, message, completions);
+
+    if ((is_terminal == true) ||
+        ((is_end == true) && (--query->remaining_end_count == 0))) {
+      // anything older that already timed out has been answered by now
+      for (auto older{m_pending_queries.begin()}; older != query;) {
+        if ((older->is_expired == true) && (older->label.empty() == true)) {
+          older = m_pending_queries.erase(older);
+          --m_pending_query_count;
+        } else {
+          ++older;
+        }
+      }
+
+      complete(query, completions);
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+void vassal::irc::reply_tracker::expire(
+    const std::chrono::steady_clock::time_point now) {
+  std::vector<completion> completions{};
+
+  {
+    std::unique_lock<std::mutex> pending_queries_lock{
+        m_pending_queries_mutex};
+
+    for (auto query{m_pending_queries.begin()};
+         query != m_pending_queries.end();) {
+      if (query->deadline > now) {
+        ++query;
+        continue;
+      }
+
+      // a server that hasn't answered within the grace period as well is
+      // not going to
+      if (query->is_expired == true) {
+        query = m_pending_queries.erase(query);
+        --m_pending_query_count;
+        continue;
+      }
+
+      query->is_expired = true;
+      resolve(*query, completions);
+
+      // unlabeled queries stay behind to swallow their late replies, so
+      // those are not mistaken for replies to the next query
+      if (query->label.empty() == false) {
+        query = m_pending_queries.erase(query);
+        --m_pending_query_count;
+      } else {
+        query->deadline = now + m_k_late_reply_grace;
+        ++query;
+      }
+    }
+  }
+
+  run(completions);
+}
+
+void vassal::irc::reply_tracker::close() {
+  std::vector<completion> completions{};
+
+  {
+    std::unique_lock<std::mutex> pending_queries_lock{
+        m_pending_queries_mutex};
+
+    for (auto query{m_pending_queries.begin()};
+         query != m_pending_queries.end(); ++query) {
+      if (query->is_expired == false) {
+        resolve(*query, completions);
+      }
+    }
+
+    m_pending_queries.clear();
+    m_pending_query_count = 0;
+  }
+
+  run(completions);
+}
+
+std::chrono::steady_clock::time_point
+vassal::irc::reply_tracker::get_next_deadline() const {
+  std::chrono::steady_clock::time_point next_deadline{
+      std::chrono::steady_clock::time_point::max()};
+
+  if (m_pending_query_count.load(std::memory_order_relaxed) == 0) {
+    return next_deadline;
+  }
+
+  std::unique_lock<std::mutex> pending_queries_lock{m_pending_queries_mutex};
+
+  for (auto query{m_pending_queries.begin()}; query != m_pending_queries.end();
+       ++query) {
+    next_deadline = std::min(next_deadline, query->deadline);
+  }
+
+  return next_deadline;
+}
+
+bool vassal::irc::reply_tracker::get_is_labeled_response_enabled() const {
+  return m_is_labeled_response_enabled;
+}
+
+void vassal::irc::reply_tracker::handle_capabilities(
+    const message_view &message) {
+  const std::string_view subcommand{message.get_param(1)};
+  const bool is_ack{subcommand == "ACK"};
+
+  if ((is_ack == false) && (subcommand != "DEL")) {
+    return;
+  }
+
+  std::string_view capabilities{message.get_body()};
+  while (capabilities.empty() == false) {
+    const std::size_t capability_end{
+        std::min(capabilities.find(' '), capabilities.size())};
+    const std::string_view capability{capabilities.substr(0, capability_end)};
+
+    if (capability == k_labeled_response) {
+      m_is_labeled_response_enabled = is_ack;
+    } else if ((capability.starts_with('-') == true) &&
+               (capability.substr(1) == k_labeled_response)) {
+      m_is_labeled_response_enabled = false;
+    }
+
+    capabilities.remove_prefix(
+        std::min((capability_end + 1), capabilities.size()));
+  }
+}
+
+void vassal::irc::reply_tracker::collect(
+    pending_query &query, const message_view &message,
+    std::vector<completion> &completions) {
+  // a query that timed out has already handed over its reply, so whatever
+  // still trickles in for it is only swallowed
+  if (query.is_expired == true) {
+    return;
+  }
+
+  if ((query.on_row) &&
+      (contains(k_reply_specs[static_cast<std::size_t>(query.kind)].replies,
+                numeric_codes::parse_code(message.get_keyword())) == true)) {
+    completions.push_back(completion{callback{}, std::promise<reply>{},
+                                     reply{{}, false}, query.on_row,
+                                     message});
+  } else {
+    query.result.messages.push_back(message);
+  }
+}
+
+void vassal::irc::reply_tracker::resolve(
+    pending_query &query, std::vector<completion> &completions) {
+  completions.push_back(completion{
+      std::move(query.on_reply), std::move(query.promise),
+      std::move(query.result), nullptr, message_view{}});
+
+  query.result = reply{{}, false};
+}
+
+void vassal::irc::reply_tracker::complete(
+    const std::list<pending_query>::iterator query,
+    std::vector<completion> &completions) {
+  if (query->is_expired == false) {
+    query->result.is_complete = true;
+    resolve(*query, completions);
+  }
+
+  m_pending_queries.erase(query);
+  --m_pending_query_count;
+}
+
+void vassal::irc::reply_tracker::run(std::vector<completion> &completions) {
+  for (size_t i{0}; i < completions.size(); ++i) {
+    if (completions[i].on_row) {
+      (*completions[i].on_row)(completions[i].row);
+    } else if (completions[i].on_reply) {
+      completions[i].on_reply(std::move(completions[i].result));
+    } else {
+      completions[i].promise.set_value(std::move(completions[i].result));
+    }
+  }
+}
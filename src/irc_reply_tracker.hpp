@@ -0,0 +1,141 @@
+#ifndef VASSAL_IRC_REPLY_TRACKER_HPP
+#define VASSAL_IRC_REPLY_TRACKER_HPP
+
+#include "irc_message_view.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vassal {
+
+namespace irc {
+// Collects the numeric replies to outstanding queries (WHOIS, NAMES, LIST,
+// WHO, STATS) and hands each query its replies through a future once the
+// end-of-reply numeric arrives. Servers answer a connection's commands in
+// order, so an untagged reply belongs to the oldest outstanding query that
+// accepts its numeric. Once the server has acknowledged the IRCv3
+// labeled-response capability (requested by the caller through CAP REQ),
+// queries are labeled instead and matched by label and batch. The errors
+// that several commands share are only taken by a query they belong to: no
+// such nick or server must name one of the query's targets, and no
+// privileges, which names nothing, must answer the oldest query.
+//
+// A query given a row callback streams instead: each reply row (each 322 of
+// a LIST, say) is handed to the callback as it arrives and then dropped, so
+// the reply only holds the end-of-reply numeric and any errors. Row
+// callbacks run after the tracker is unlocked, so they may add queries.
+class reply_tracker {
+public:
+  enum class query_kind {
+    whois = 0,
+    names,
+    list,
+    who,
+    stats,
+    N,
+  };
+
+  struct reply {
+    std::vector<message_view> messages;
+    bool is_complete; // false if the query timed out or the connection closed
+  };
+
+  using callback = std::function<void(reply &&result)>;
+  using row_callback = std::function<void(const message_view &row)>;
+
+private:
+  struct pending_query {
+    query_kind kind;
+    std::string label;
+    std::string batch;
+    std::string targets;
+    std::size_t remaining_end_count;
+    std::chrono::steady_clock::time_point deadline;
+    std::promise<reply> promise;
+    callback on_reply;
+    std::shared_ptr<row_callback> on_row;
+    reply result;
+    bool is_expired;
+  };
+
+  // either a finished reply or a single streamed row, handed over in arrival
+  // order so a query's last rows come before its reply
+  struct completion {
+    callback on_reply;
+    std::promise<reply> promise;
+    reply result;
+    std::shared_ptr<row_callback> on_row;
+    message_view row;
+  };
+
+private:
+  // how long a timed-out unlabeled query keeps swallowing its late replies
+  static constexpr std::chrono::seconds m_k_late_reply_grace{30};
+
+private:
+  std::list<pending_query> m_pending_queries;
+  mutable std::mutex m_pending_queries_mutex;
+  std::atomic<std::size_t> m_pending_query_count;
+
+  std::atomic<bool> m_is_labeled_response_enabled;
+  std::uint64_t m_next_label;
+
+public:
+  reply_tracker();
+
+  reply_tracker(const reply_tracker &other) = delete;
+  reply_tracker(reply_tracker &&other) = delete;
+
+  ~reply_tracker();
+
+public:
+  std::string make_label();
+  std::future<reply> add(const query_kind kind, const std::string &label,
+                         const std::string_view message,
+                         const std::size_t end_count,
+                         const std::chrono::milliseconds timeout,
+                         row_callback on_row = row_callback{});
+  void add(const query_kind kind, const std::string &label,
+           const std::string_view message, const std::size_t end_count,
+           const std::chrono::milliseconds timeout, callback on_reply);
+  bool remove(const std::string &label);
+
+  bool is_interested(const std::string_view command_token) const;
+  bool handle(const message_view &message);
+
+  void expire(const std::chrono::steady_clock::time_point now);
+  void close();
+
+  std::chrono::steady_clock::time_point get_next_deadline() const;
+  bool get_is_labeled_response_enabled() const;
+
+public:
+  reply_tracker &operator=(const reply_tracker &other) = delete;
+  reply_tracker &operator=(reply_tracker &&other) = delete;
+
+private:
+  bool match(const message_view &message,
+             std::vector<completion> &completions);
+  void handle_capabilities(const message_view &message);
+  void collect(pending_query &query, const message_view &message,
+               std::vector<completion> &completions);
+  void resolve(pending_query &query, std::vector<completion> &completions);
+  void complete(const std::list<pending_query>::iterator query,
+                std::vector<completion> &completions);
+
+  static void run(std::vector<completion> &completions);
+};
+} // namespace irc
+
+} // namespace vassal
+#endif
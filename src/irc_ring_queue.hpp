@@ -0,0 +1,213 @@
+#ifndef VASSAL_IRC_RING_QUEUE_HPP
+#define VASSAL_IRC_RING_QUEUE_HPP
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace vassal {
+
+namespace irc {
+inline constexpr std::size_t k_cache_line_size{64};
+
+// Bounded single-producer/single-consumer ring. Each side keeps a private copy
+// of the other side's cursor and only reloads it when the ring looks full (or
+// empty), so steady-state pushes and pops touch no shared cache line besides
+// the slot itself.
+template <typename T> class spsc_ring_queue {
+private:
+  struct slot {
+    alignas(T) std::byte storage[sizeof(T)];
+  };
+
+private:
+  std::size_t m_mask;
+  std::unique_ptr<slot[]> m_slots;
+
+  alignas(k_cache_line_size) std::atomic<std::size_t> m_head;
+  std::size_t m_cached_tail;
+
+  alignas(k_cache_line_size) std::atomic<std::size_t> m_tail;
+  std::size_t m_cached_head;
+
+public:
+  explicit spsc_ring_queue(const std::size_t capacity)
+      : m_mask{std::bit_ceil((capacity < 2) ? std::size_t{2} : capacity) - 1},
+        m_slots{new slot[m_mask + 1]}, m_head{0}, m_cached_tail{0}, m_tail{0},
+        m_cached_head{0} {}
+
+  spsc_ring_queue(const spsc_ring_queue &other) = delete;
+  spsc_ring_queue(spsc_ring_queue &&other) = delete;
+
+  ~spsc_ring_queue() {
+    T value{};
+    while (try_pop(value) == true) {
+    }
+  }
+
+public:
+  bool try_push(T &&value) {
+    const std::size_t tail{m_tail.load(std::memory_order_relaxed)};
+
+    if ((tail - m_cached_head) > m_mask) {
+      m_cached_head = m_head.load(std::memory_order_acquire);
+      if ((tail - m_cached_head) > m_mask) {
+        return false;
+      }
+    }
+
+    new (m_slots[tail & m_mask].storage) T{std::move(value)};
+    m_tail.store(tail + 1, std::memory_order_release);
+
+    return true;
+  }
+
+  bool try_pop(T &value) {
+    const std::size_t head{m_head.load(std::memory_order_relaxed)};
+
+    if (head == m_cached_tail) {
+      m_cached_tail = m_tail.load(std::memory_order_acquire);
+      if (head == m_cached_tail) {
+        return false;
+      }
+    }
+
+    T *element{std::launder(
+        reinterpret_cast<T *>(m_slots[head & m_mask].storage))};
+    value = std::move(*element);
+    element->~T();
+    m_head.store(head + 1, std::memory_order_release);
+
+    return true;
+  }
+
+  std::size_t get_size() const {
+    return (m_tail.load(std::memory_order_acquire) -
+            m_head.load(std::memory_order_acquire));
+  }
+
+  std::size_t get_capacity() const { return (m_mask + 1); }
+
+public:
+  spsc_ring_queue &operator=(const spsc_ring_queue &other) = delete;
+  spsc_ring_queue &operator=(spsc_ring_queue &&other) = delete;
+};
+
+// Bounded multi-producer/multi-consumer ring. Every cell carries a sequence
+// number that tells producers and consumers whose turn it is, so claiming a
+// cell is a single compare-exchange on the shared cursor.
+template <typename T> class mpmc_ring_queue {
+private:
+  struct cell {
+    std::atomic<std::size_t> sequence;
+    alignas(T) std::byte storage[sizeof(T)];
+  };
+
+private:
+  std::size_t m_mask;
+  std::unique_ptr<cell[]> m_cells;
+
+  alignas(k_cache_line_size) std::atomic<std::size_t> m_enqueue_pos;
+  alignas(k_cache_line_size) std::atomic<std::size_t> m_dequeue_pos;
+
+public:
+  explicit mpmc_ring_queue(const std::size_t capacity)
+      : m_mask{std::bit_ceil((capacity < 2) ? std::size_t{2} : capacity) - 1},
+        m_cells{new cell[m_mask + 1]}, m_enqueue_pos{0}, m_dequeue_pos{0} {
+    for (std::size_t i{0}; i <= m_mask; ++i) {
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  mpmc_ring_queue(const mpmc_ring_queue &other) = delete;
+  mpmc_ring_queue(mpmc_ring_queue &&other) = delete;
+
+  ~mpmc_ring_queue() {
+    T value{};
+    while (try_pop(value) == true) {
+    }
+  }
+
+public:
+  bool try_push(T &&value) {
+    std::size_t pos{m_enqueue_pos.load(std::memory_order_relaxed)};
+    cell *target{nullptr};
+
+    while (true) {
+      target = &m_cells[pos & m_mask];
+      const std::intptr_t difference{
+          static_cast<std::intptr_t>(
+              target->sequence.load(std::memory_order_acquire)) -
+          static_cast<std::intptr_t>(pos)};
+
+      if (difference == 0) {
+        if (m_enqueue_pos.compare_exchange_weak(
+                pos, (pos + 1), std::memory_order_relaxed) == true) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        pos = m_enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+
+    new (target->storage) T{std::move(value)};
+    target->sequence.store((pos + 1), std::memory_order_release);
+
+    return true;
+  }
+
+  bool try_pop(T &value) {
+    std::size_t pos{m_dequeue_pos.load(std::memory_order_relaxed)};
+    cell *target{nullptr};
+
+    while (true) {
+      target = &m_cells[pos & m_mask];
+      const std::intptr_t difference{
+          static_cast<std::intptr_t>(
+              target->sequence.load(std::memory_order_acquire)) -
+          static_cast<std::intptr_t>(pos + 1)};
+
+      if (difference == 0) {
+        if (m_dequeue_pos.compare_exchange_weak(
+                pos, (pos + 1), std::memory_order_relaxed) == true) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        pos = m_dequeue_pos.load(std::memory_order_relaxed);
+      }
+    }
+
+    T *element{std::launder(reinterpret_cast<T *>(target->storage))};
+    value = std::move(*element);
+    element->~T();
+    target->sequence.store((pos + m_mask + 1), std::memory_order_release);
+
+    return true;
+  }
+
+  std::size_t get_size() const {
+    const std::size_t enqueue_pos{
+        m_enqueue_pos.load(std::memory_order_acquire)};
+    const std::size_t dequeue_pos{
+        m_dequeue_pos.load(std::memory_order_acquire)};
+    return ((enqueue_pos > dequeue_pos) ? (enqueue_pos - dequeue_pos) : 0);
+  }
+
+  std::size_t get_capacity() const { return (m_mask + 1); }
+
+public:
+  mpmc_ring_queue &operator=(const mpmc_ring_queue &other) = delete;
+  mpmc_ring_queue &operator=(mpmc_ring_queue &&other) = delete;
+};
+} // namespace irc
+
+} // namespace vassal
+#endif
@@ -0,0 +1,374 @@
+#include "irc_send_scheduler.hpp"
+
+#include "irc_commands.hpp"
+#include "irc_framer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace {
+struct mode_line {
+  std::string_view target;
+  std::string_view modes;
+  std::string_view params;
+};
+
+// only plain channel MODE changes are merged; queries (no sign) and anything
+// with a trailing parameter are left alone
+bool parse_mode_line(std::string_view line, mode_line &value) {
+  const std::size_t command_end{line.find(' ')};
+  if ((command_end == std::string_view::npos) ||
+      (vassal::irc::commands::lookup(line.substr(0, command_end)) !=
+       vassal::irc::command::mode)) {
+    return false;
+  }
+  line.remove_prefix(command_end + 1);
+
+  const std::size_t target_end{line.find(' ')};
+  if ((target_end == std::string_view::npos) || (target_end == 0) ||
+      (std::string_view{"#&+!"}.find(line.front()) ==
+       std::string_view::npos)) {
+    return false;
+  }
+  value.target = line.substr(0, target_end);
+  line.remove_prefix(target_end + 1);
+
+  const std::size_t modes_end{std::min(line.find(' '), line.size())};
+  value.modes = line.substr(0, modes_end);
+  if ((value.modes.size() < 2) ||
+      ((value.modes.front() != '+') && (value.modes.front() != '-'))) {
+    return false;
+  }
+
+  value.params = line.substr(std::min((modes_end + 1), line.size()));
+  if ((value.params.starts_with(':') == true) ||
+      (value.params.find(" :") != std::string_view::npos)) {
+    return false;
+  }
+
+  return true;
+}
+
+std::size_t count_modes(const std::string_view modes) {
+  return static_cast<std::size_t>(
+      std::count_if(modes.begin(), modes.end(),
+                    [](const char c) { return ((c != '+') && (c != '-')); }));
+}
+
+std::size_t count_params(std::string_view params) {
+  std::size_t count{0};
+  while (params.empty() == false) {
+    const std::size_t param_end{std::min(params.find(' '), params.size())};
+    if (param_end != 0) {
+      ++count;
+    }
+    params.remove_prefix(std::min((param_end + 1), params.size()));
+  }
+
+  return count;
+}
+
+// RFC 2811's channel modes, as CHANMODES types A and B, C, D and PREFIX
+constexpr std::string_view k_default_param_modes{"beIk"};
+constexpr std::string_view k_default_set_param_modes{"l"};
+constexpr std::string_view k_default_flag_modes{"aimnqpsrt"};
+constexpr std::string_view k_default_prefix_modes{"Oov"};
+} // namespace
+
+vassal::irc::send_scheduler::send_scheduler(const config &scheduler_config)
+    : m_config{scheduler_config}, m_lanes{}, m_size{0}, m_merged_count{0},
+      m_line_tokens{static_cast<double>(scheduler_config.line_limit)},
+      m_byte_tokens{static_cast<double>(scheduler_config.byte_limit)},
+      m_last_refill{std::chrono::steady_clock::now()},
+      m_param_modes{k_default_param_modes},
+      m_set_param_modes{k_default_set_param_modes},
+      m_flag_modes{k_default_flag_modes},
+      m_prefix_modes{k_default_prefix_modes} {
+  if (((m_config.line_limit != 0) || (m_config.byte_limit != 0)) &&
+      (m_config.window <= std::chrono::milliseconds::zero())) {
+    throw std::runtime_error{"send window must be positive"};
+  }
+}
+
+vassal::irc::send_scheduler::~send_scheduler() {}
+
+void vassal::irc::send_scheduler::push(const priority lane,
+                                       std::string &&line) {
+  if (lane >= priority::N) {
+    throw std::runtime_error{"invalid send priority"};
+  }
+
+  std::deque<std::string> &queued{m_lanes[static_cast<std::size_t>(lane)]};
+
+  if (((lane == priority::bulk) || (lane == priority::background)) &&
+      (m_config.max_modes_per_line != 0) && (queued.empty() == false) &&
+      (merge_mode(queued.back(), line) == true)) {
+    ++m_merged_count;
+    return;
+  }
+
+  queued.push_back(std::move(line));
+  ++m_size;
+}
+
+bool vassal::irc::send_scheduler::pop(
+    const std::chrono::steady_clock::time_point now, std::string &line) {
+  std::deque<std::string> *const lane{get_front_lane()};
+  if (lane == nullptr) {
+    return false;
+  }
+
+  refill(now);
+
+  const std::size_t byte_cost{get_byte_cost(lane->front())};
+
+  if ((m_config.line_limit != 0) && (m_line_tokens < 1.0)) {
+    return false;
+  }
+  if ((m_config.byte_limit != 0) &&
+      (m_byte_tokens < static_cast<double>(byte_cost))) {
+    return false;
+  }
+
+  if (m_config.line_limit != 0) {
+    m_line_tokens -= 1.0;
+  }
+  if (m_config.byte_limit != 0) {
+    m_byte_tokens -= static_cast<double>(byte_cost);
+  }
+
+  line = std::move(lane->front());
+  lane->pop_front();
+  --m_size;
+
+  return true;
+}
+
+bool vassal::irc::send_scheduler::pop_unpaced(const priority lane,
+                                              std::string &line) {
+  if (lane >= priority::N) {
+    throw std::runtime_error{"invalid send priority"};
+  }
+
+  std::deque<std::string> &queued{m_lanes[static_cast<std::size_t>(lane)]};
+  if (queued.empty() == true) {
+    return false;
+  }
+
+  line = std::move(queued.front());
+  queued.pop_front();
+  --m_size;
+
+  return true;
+}
+
+void vassal::irc::send_scheduler::set_channel_modes(
+    const std::string_view chanmodes) {
+  // "beI,k,l,imnpst", where types past the fourth are left out and so never
+  // merged
+  std::array<std::string, 4> types{};
+  std::string_view remaining{chanmodes};
+  for (size_t i{0}; i < types.size(); ++i) {
+    const std::size_t type_end{std::min(remaining.find(','), remaining.size())};
+    types[i] = remaining.substr(0, type_end);
+    remaining.remove_prefix(std::min((type_end + 1), remaining.size()));
+  }
+
+  m_param_modes = types[0] + types[1];
+  m_set_param_modes = std::move(types[2]);
+  m_flag_modes = std::move(types[3]);
+}
+
+void vassal::irc::send_scheduler::set_prefix_modes(
+    const std::string_view prefix) {
+  // "(ov)@+"
+  if (prefix.starts_with('(') == false) {
+    m_prefix_modes.clear();
+    return;
+  }
+
+  m_prefix_modes = prefix.substr(1, (prefix.find(')') - 1));
+}
+
+std::chrono::steady_clock::time_point
+vassal::irc::send_scheduler::get_next_ready() const {
+  const std::deque<std::string> *const lane{get_front_lane()};
+  if (lane == nullptr) {
+    return std::chrono::steady_clock::time_point::max();
+  }
+
+  const double window{
+      std::chrono::duration<double>{m_config.window}.count()};
+  double wait{0.0};
+
+  if ((m_config.line_limit != 0) && (m_line_tokens < 1.0)) {
+    wait = std::max(wait, ((1.0 - m_line_tokens) * window /
+                           static_cast<double>(m_config.line_limit)));
+  }
+
+  const double byte_cost{static_cast<double>(get_byte_cost(lane->front()))};
+  if ((m_config.byte_limit != 0) && (m_byte_tokens < byte_cost)) {
+    wait = std::max(wait, ((byte_cost - m_byte_tokens) * window /
+                           static_cast<double>(m_config.byte_limit)));
+  }
+
+  return (m_last_refill + std::chrono::ceil<std::chrono::nanoseconds>(
+                              std::chrono::duration<double>{wait}));
+}
+
+bool vassal::irc::send_scheduler::is_empty() const { return (m_size == 0); }
+
+std::size_t vassal::irc::send_scheduler::get_size() const { return m_size; }
+
+std::size_t vassal::irc::send_scheduler::get_merged_count() const {
+  return m_merged_count;
+}
+
+vassal::irc::send_scheduler::priority
+vassal::irc::send_scheduler::classify(const std::string_view line) {
+  switch (commands::lookup(framer::get_command_token(line))) {
+  case irc::command::ping:
+  case irc::command::pong:
+  case irc::command::quit:
+    return priority::urgent;
+  case irc::command::mode:
+  case irc::command::kick:
+  case irc::command::who:
+  case irc::command::whois:
+  case irc::command::whowas:
+  case irc::command::names:
+  case irc::command::list:
+  case irc::command::stats:
+    return priority::bulk;
+  default:
+    return priority::interactive;
+  }
+}
+
+void vassal::irc::send_scheduler::refill(
+    const std::chrono::steady_clock::time_point now) {
+  if (now <= m_last_refill) {
+    return;
+  }
+
+  const double windows{std::chrono::duration<double>{now - m_last_refill} /
+                       std::chrono::duration<double>{m_config.window}};
+
+  m_line_tokens =
+      std::min(static_cast<double>(m_config.line_limit),
+               (m_line_tokens +
+                (windows * static_cast<double>(m_config.line_limit))));
+  m_byte_tokens =
+      std::min(static_cast<double>(m_config.byte_limit),
+               (m_byte_tokens +
+                (windows * static_cast<double>(m_config.byte_limit))));
+  m_last_refill = now;
+}
+
+std::deque<std::string> *vassal::irc::send_scheduler::get_front_lane() {
+  for (size_t i{0}; i < m_lanes.size(); ++i) {
+    if (m_lanes[i].empty() == false) {
+      return &m_lanes[i];
+    }
+  }
+
+  return nullptr;
+}
+
+const std::deque<std::string> *
+vassal::irc::send_scheduler::get_front_lane() const {
+  for (size_t i{0}; i < m_lanes.size(); ++i) {
+    if (m_lanes[i].empty() == false) {
+      return &m_lanes[i];
+    }
+  }
+
+  return nullptr;
+}
+
+std::size_t
+vassal::irc::send_scheduler::get_byte_cost(const std::string &line) const {
+  // a line larger than the whole bucket would otherwise never go out
+  return std::min((line.size() + m_k_delimiter_length),
+                  std::max<std::size_t>(m_config.byte_limit, 1));
+}
+
+std::size_t vassal::irc::send_scheduler::count_mode_params(
+    const std::string_view modes) const {
+  std::size_t count{0};
+  char sign{'+'};
+
+  for (size_t i{0}; i < modes.size(); ++i) {
+    const char mode{modes[i]};
+
+    if ((mode == '+') || (mode == '-')) {
+      sign = mode;
+    } else if ((m_param_modes.find(mode) != std::string::npos) ||
+               (m_prefix_modes.find(mode) != std::string::npos)) {
+      ++count;
+    } else if (m_set_param_modes.find(mode) != std::string::npos) {
+      if (sign == '+') {
+        ++count;
+      }
+    } else if (m_flag_modes.find(mode) == std::string::npos) {
+      return std::string::npos;
+    }
+  }
+
+  return count;
+}
+
+bool vassal::irc::send_scheduler::merge_mode(
+    std::string &queued, const std::string_view line) const {
+  mode_line earlier{};
+  mode_line later{};
+  if ((parse_mode_line(queued, earlier) == false) ||
+      (parse_mode_line(line, later) == false) ||
+      (earlier.target != later.target) ||
+      ((count_modes(earlier.modes) + count_modes(later.modes)) >
+       m_config.max_modes_per_line)) {
+    return false;
+  }
+
+  // parameters are matched up with modes by position, so a line short of
+  // one (a list query) or with one to spare would hand it to the other line
+  if ((count_params(earlier.params) != count_mode_params(earlier.modes)) ||
+      (count_params(later.params) != count_mode_params(later.modes))) {
+    return false;
+  }
+
+  // a sign repeating the one already in effect can go
+  const char earlier_sign{earlier.modes[earlier.modes.find_last_of("+-")]};
+  const std::string_view later_modes{(later.modes.front() == earlier_sign)
+                                         ? later.modes.substr(1)
+                                         : later.modes};
+
+  std::string merged{"MODE "};
+  merged.append(earlier.target);
+  merged.append(" ");
+  merged.append(earlier.modes);
+  merged.append(later_modes);
+  if (earlier.params.empty() == false) {
+    merged.append(" ");
+    merged.append(earlier.params);
+  }
+  if (later.params.empty() == false) {
+    merged.append(" ");
+    merged.append(later.params);
+  }
+
+  if (merged.size() > m_k_max_line_length) {
+    return false;
+  }
+
+  queued = std::move(merged);
+
+  return true;
+}
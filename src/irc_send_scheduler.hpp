@@ -0,0 +1,104 @@
+#ifndef VASSAL_IRC_SEND_SCHEDULER_HPP
+#define VASSAL_IRC_SEND_SCHEDULER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <string_view>
+
+namespace vassal {
+
+namespace irc {
+// Paces outbound lines to stay under a server's flood limits. Lines wait in
+// one of four priority lanes and are released highest lane first, as long as
+// a token bucket allowing line_limit lines and byte_limit bytes (CRLF
+// included) per window has room; either limit may be 0 for none. The buckets
+// start full, so a quiet connection can burst up to the limits.
+//
+// A channel MODE queued in the bulk or background lane is merged into the
+// MODE just before it in that lane when both name the same target and the
+// merged line carries no more than max_modes_per_line mode changes. Both
+// lines must carry exactly the parameters their modes take, going by the
+// server's CHANMODES and PREFIX (RFC 2811's modes until those are known), so
+// a list query like "MODE #c +b" or a mode we don't know is never merged.
+// Not thread safe.
+class send_scheduler {
+public:
+  enum class priority {
+    urgent = 0,  // PING, PONG and QUIT
+    interactive, // anything not listed elsewhere
+    bulk,        // MODE, KICK and the queries (WHO, WHOIS, NAMES, ...)
+    background,  // only ever chosen by the caller
+    N,
+  };
+
+  struct config {
+    std::size_t line_limit{0};
+    std::size_t byte_limit{0};
+    std::chrono::milliseconds window{1000};
+    std::size_t max_modes_per_line{3}; // 0 disables MODE merging
+  };
+
+private:
+  config m_config;
+
+  std::array<std::deque<std::string>, static_cast<std::size_t>(priority::N)>
+      m_lanes;
+  std::size_t m_size;
+  std::size_t m_merged_count;
+
+  double m_line_tokens;
+  double m_byte_tokens;
+  std::chrono::steady_clock::time_point m_last_refill;
+
+  std::string m_param_modes;     // CHANMODES types A and B
+  std::string m_set_param_modes; // CHANMODES type C, a parameter when set
+  std::string m_flag_modes;      // CHANMODES type D
+  std::string m_prefix_modes;
+
+private:
+  static constexpr std::size_t m_k_max_line_length{510};
+  static constexpr std::size_t m_k_delimiter_length{2};
+
+public:
+  explicit send_scheduler(const config &scheduler_config);
+
+  send_scheduler(const send_scheduler &other) = delete;
+  send_scheduler(send_scheduler &&other) = delete;
+
+  ~send_scheduler();
+
+public:
+  void push(const priority lane, std::string &&line);
+  bool pop(const std::chrono::steady_clock::time_point now, std::string &line);
+  bool pop_unpaced(const priority lane, std::string &line);
+
+  void set_channel_modes(const std::string_view chanmodes);
+  void set_prefix_modes(const std::string_view prefix);
+
+  std::chrono::steady_clock::time_point get_next_ready() const;
+  bool is_empty() const;
+  std::size_t get_size() const;
+  std::size_t get_merged_count() const;
+
+  static priority classify(const std::string_view line);
+
+public:
+  send_scheduler &operator=(const send_scheduler &other) = delete;
+  send_scheduler &operator=(send_scheduler &&other) = delete;
+
+private:
+  void refill(const std::chrono::steady_clock::time_point now);
+  std::deque<std::string> *get_front_lane();
+  const std::deque<std::string> *get_front_lane() const;
+  std::size_t get_byte_cost(const std::string &line) const;
+
+  std::size_t count_mode_params(const std::string_view modes) const;
+  bool merge_mode(std::string &queued, const std::string_view line) const;
+};
+} // namespace irc
+
+} // namespace vassal
+#endif
@@ -0,0 +1,175 @@
+#include "irc_spill_buffer.hpp"
+
+#include "irc_message_view.hpp"
+#include "irc_receive_buffer.hpp"
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+vassal::irc::spill_buffer::spill_buffer(const std::string &directory)
+    : m_directory{directory}, m_fd{-1}, m_write_offset{0}, m_read_offset{0},
+      m_line_count{0}, m_read_ahead{}, m_read_ahead_pos{0},
+      m_receive_buffer_pool{m_k_buffer_capacity},
+      m_buffer{m_receive_buffer_pool.acquire()} {}
+
+vassal::irc::spill_buffer::~spill_buffer() {
+  if (m_fd != -1) {
+    ::close(m_fd);
+    m_fd = -1;
+  }
+}
+
+bool vassal::irc::spill_buffer::push(const std::string_view line) {
+  if ((m_fd == -1) && (open_file() == false)) {
+    return false;
+  }
+
+  static constexpr char k_line_feed{'\n'};
+
+  std::size_t written{0};
+  const std::size_t total{line.size() + 1};
+
+  while (written < total) {
+    iovec parts[2]{};
+    int part_count{0};
+    if (written < line.size()) {
+      parts[part_count++] = iovec{const_cast<char *>(line.data() + written),
+                                  (line.size() - written)};
+    }
+    parts[part_count++] = iovec{const_cast<char *>(&k_line_feed), 1};
+
+    const ssize_t result{::pwritev(m_fd, parts, part_count,
+                                   static_cast<off_t>(m_write_offset +
+                                                      written))};
+    if (result == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+
+    written += static_cast<std::size_t>(result);
+  }
+
+  m_write_offset += total;
+  ++m_line_count;
+
+  return true;
+}
+
+bool vassal::irc::spill_buffer::pop(message_view &value) {
+  if (m_line_count == 0) {
+    return false;
+  }
+
+  std::size_t line_end{m_read_ahead_pos};
+  while (true) {
+    const auto found{std::find((m_read_ahead.begin() + line_end),
+                               m_read_ahead.end(), '\n')};
+    if (found != m_read_ahead.end()) {
+      line_end = static_cast<std::size_t>(found - m_read_ahead.begin());
+      break;
+    }
+
+    line_end = m_read_ahead.size() - m_read_ahead_pos;
+    if (fill_read_ahead() == false) {
+      return false;
+    }
+  }
+
+  const std::string_view line{(m_read_ahead.data() + m_read_ahead_pos),
+                              (line_end - m_read_ahead_pos)};
+
+  if (m_buffer->get_free_space() < line.size()) {
+    m_buffer = m_receive_buffer_pool.acquire(line.size());
+  }
+  const std::size_t pos{m_buffer->get_size()};
+  m_buffer->append(line);
+  value = message_view{m_buffer, m_buffer->get_view(pos, line.size())};
+
+  m_read_ahead_pos = line_end + 1;
+  --m_line_count;
+
+  if (m_line_count == 0) {
+    reset();
+  }
+
+  return true;
+}
+
+bool vassal::irc::spill_buffer::is_empty() const {
+  return (m_line_count == 0);
+}
+
+std::size_t vassal::irc::spill_buffer::get_size() const {
+  return m_line_count;
+}
+
+bool vassal::irc::spill_buffer::open_file() {
+  m_fd = ::open(m_directory.c_str(), (O_TMPFILE | O_RDWR | O_CLOEXEC), 0600);
+  if (m_fd != -1) {
+    return true;
+  }
+
+  // not every filesystem supports O_TMPFILE
+  std::string path{m_directory + "/vassal-spill-XXXXXX"};
+  m_fd = ::mkostemp(path.data(), O_CLOEXEC);
+  if (m_fd == -1) {
+    return false;
+  }
+  ::unlink(path.c_str());
+
+  return true;
+}
+
+bool vassal::irc::spill_buffer::fill_read_ahead() {
+  m_read_ahead.erase(m_read_ahead.begin(),
+                     (m_read_ahead.begin() + m_read_ahead_pos));
+  m_read_ahead_pos = 0;
+
+  const std::size_t to_read{
+      std::min(m_k_read_ahead_size, (m_write_offset - m_read_offset))};
+  if (to_read == 0) {
+    return false;
+  }
+
+  const std::size_t old_size{m_read_ahead.size()};
+  m_read_ahead.resize(old_size + to_read);
+
+  std::size_t read{0};
+  while (read < to_read) {
+    const ssize_t result{
+        ::pread(m_fd, (m_read_ahead.data() + old_size + read),
+                (to_read - read), static_cast<off_t>(m_read_offset + read))};
+    if ((result == -1) && (errno == EINTR)) {
+      continue;
+    }
+    if (result <= 0) {
+      break;
+    }
+    read += static_cast<std::size_t>(result);
+  }
+
+  m_read_ahead.resize(old_size + read);
+  m_read_offset += read;
+
+  return (read != 0);
+}
+
+void vassal::irc::spill_buffer::reset() {
+  [[maybe_unused]] const int result{::ftruncate(m_fd, 0)};
+
+  m_write_offset = 0;
+  m_read_offset = 0;
+  m_read_ahead.clear();
+  m_read_ahead_pos = 0;
+}
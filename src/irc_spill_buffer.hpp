@@ -0,0 +1,65 @@
+#ifndef VASSAL_IRC_SPILL_BUFFER_HPP
+#define VASSAL_IRC_SPILL_BUFFER_HPP
+
+#include "irc_message_view.hpp"
+#include "irc_receive_buffer.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vassal {
+
+namespace irc {
+// FIFO of raw lines kept in an unlinked temporary file. The inbound queue
+// spills into it once its ring is full; lines read back are copied into
+// pooled receive buffers so the views handed out own their storage. The file
+// is created on first use and truncated whenever it drains. Not thread safe.
+class spill_buffer {
+private:
+  std::string m_directory;
+  int m_fd;
+
+  std::size_t m_write_offset;
+  std::size_t m_read_offset;
+  std::size_t m_line_count;
+
+  std::vector<char> m_read_ahead;
+  std::size_t m_read_ahead_pos;
+
+  receive_buffer_pool m_receive_buffer_pool;
+  receive_buffer_ref m_buffer;
+
+private:
+  static constexpr std::size_t m_k_read_ahead_size{65536};
+  static constexpr std::size_t m_k_buffer_capacity{16384};
+
+public:
+  explicit spill_buffer(const std::string &directory);
+
+  spill_buffer(const spill_buffer &other) = delete;
+  spill_buffer(spill_buffer &&other) = delete;
+
+  ~spill_buffer();
+
+public:
+  bool push(const std::string_view line);
+  bool pop(message_view &value);
+
+  bool is_empty() const;
+  std::size_t get_size() const;
+
+public:
+  spill_buffer &operator=(const spill_buffer &other) = delete;
+  spill_buffer &operator=(spill_buffer &&other) = delete;
+
+private:
+  bool open_file();
+  bool fill_read_ahead();
+  void reset();
+};
+} // namespace irc
+
+} // namespace vassal
+#endif
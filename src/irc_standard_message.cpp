@@ -1,6 +1,8 @@
 #include "irc_standard_message.hpp"
 
+#include "irc_commands.hpp"
 #include "irc_message.hpp"
+#include "irc_message_view.hpp"
 
 #include <cstddef>
 #include <exception>
@@ -11,20 +13,27 @@
 #include <type_traits>
 #include <utility>
 
-vassal::irc::standard_message::standard_message() : message{}, m_command{} {}
+vassal::irc::standard_message::standard_message()
+    : message{}, m_command{irc::command::unknown}, m_unknown_command{} {}
 
 vassal::irc::standard_message::standard_message(
     const std::string_view raw_message)
-    : message{raw_message}, m_command{} {
-  parse_command(raw_message);
-}
+    : standard_message{message_view{raw_message}} {}
+
+vassal::irc::standard_message::standard_message(const message_view &view)
+    : message{view}, m_command{view.get_command()},
+      m_unknown_command{((m_command == irc::command::unknown)
+                             ? view.get_keyword()
+                             : std::string_view{})} {}
 
 vassal::irc::standard_message::standard_message(const standard_message &other)
-    : message{other}, m_command{other.m_command} {}
+    : message{other}, m_command{other.m_command},
+      m_unknown_command{other.m_unknown_command} {}
 
 vassal::irc::standard_message::standard_message(
     standard_message &&other) noexcept
-    : message{std::move(other)}, m_command{std::move(other.m_command)} {}
+    : message{std::move(other)}, m_command{other.m_command},
+      m_unknown_command{std::move(other.m_unknown_command)} {}
 
 vassal::irc::standard_message::~standard_message() {}
 
@@ -43,17 +52,23 @@ vassal::irc::message::type vassal::irc::standard_message::get_type() const {
 }
 
 std::string vassal::irc::standard_message::get_keyword() const {
-  return m_command;
+  return std::string{get_command_string()};
 }
 
-std::string vassal::irc::standard_message::get_command() const {
+vassal::irc::command vassal::irc::standard_message::get_command() const {
   return m_command;
 }
 
+std::string_view vassal::irc::standard_message::get_command_string() const {
+  return ((m_command == irc::command::unknown) ? m_unknown_command
+                                               : commands::get_name(m_command));
+}
+
 vassal::irc::standard_message &
 vassal::irc::standard_message::operator=(const standard_message &other) {
   message::operator=(other);
   m_command = other.m_command;
+  m_unknown_command = other.m_unknown_command;
 
   return *this;
 }
@@ -63,7 +78,8 @@ vassal::irc::standard_message::operator=(standard_message &&other) noexcept(
     std::is_nothrow_move_assignable_v<message> &&
     std::is_nothrow_move_assignable_v<std::string>) {
   message::operator=(std::move(other));
-  m_command = std::move(other.m_command);
+  m_command = other.m_command;
+  m_unknown_command = std::move(other.m_unknown_command);
 
   return *this;
 }
@@ -71,19 +87,3 @@ vassal::irc::standard_message::operator=(standard_message &&other) noexcept(
 void vassal::irc::standard_message::print(std::ostream &out) const {
   message::print(out);
 }
-
-void vassal::irc::standard_message::parse_command(
-    const std::string_view raw_message) {
-  static constexpr std::string::size_type k_command_pos_word{2};
-  static constexpr char k_delimiter_space{' '};
-
-  std::string::size_type pos_last{std::string::npos};
-  std::string::size_type pos_cur{std::string::npos};
-
-  for (size_t i{0}; i < k_command_pos_word; ++i) {
-    pos_last = pos_cur;
-    pos_cur = raw_message.find(k_delimiter_space, (pos_last + 1));
-  }
-
-  m_command = raw_message.substr((pos_last + 1), ((pos_cur) - (pos_last + 1)));
-}
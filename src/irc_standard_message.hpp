@@ -1,6 +1,7 @@
 #ifndef VASSAL_IRC_STANDARD_MESSAGE_HPP
 #define VASSAL_IRC_STANDARD_MESSAGE_HPP
 
+#include "irc_commands.hpp"
 #include "irc_message.hpp"
 
 #include <iostream>
@@ -11,13 +12,15 @@
 namespace vassal {
 
 namespace irc {
-class standard_message : public message {
+class standard_message final : public message {
 private:
-  std::string m_command;
+  irc::command m_command;
+  std::string m_unknown_command;
 
 public:
   standard_message();
   explicit standard_message(const std::string_view raw_message);
+  explicit standard_message(const message_view &view);
   standard_message(const standard_message &other);
   standard_message(standard_message &&other) noexcept;
 
@@ -30,7 +33,8 @@ public:
   virtual type get_type() const override;
   virtual std::string get_keyword() const override;
 
-  std::string get_command() const;
+  irc::command get_command() const;
+  std::string_view get_command_string() const;
 
 public:
   standard_message &operator=(const standard_message &other);
@@ -40,9 +44,6 @@ public:
 
 protected:
   virtual void print(std::ostream &out) const override;
-
-private:
-  void parse_command(const std::string_view raw_message);
 };
 } // namespace irc
 
@@ -0,0 +1,90 @@
+#include "irc_tokenizer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+std::span<const std::string_view>
+vassal::irc::message_tokens::get_params() const {
+  return std::span<const std::string_view>{params.data(), param_count};
+}
+
+bool vassal::irc::message_tokens::is_numeric() const {
+  static constexpr std::size_t k_numeric_length{3};
+
+  if (command.size() != k_numeric_length) {
+    return false;
+  }
+
+  for (const char c : command) {
+    if ((c < '0') || (c > '9')) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+vassal::irc::message_tokens
+vassal::irc::tokenize(const std::string_view raw_message) {
+  static constexpr char k_delimiter_space{' '};
+  static constexpr char k_delimiter_colon{':'};
+  static constexpr char k_delimiter_at_sign{'@'};
+
+  message_tokens tokens{};
+  std::string_view::size_type pos{0};
+
+  auto skip_spaces{[&raw_message, &pos]() -> void {
+    while ((pos < raw_message.size()) &&
+           (raw_message[pos] == k_delimiter_space)) {
+      ++pos;
+    }
+  }};
+
+  auto next_word{[&raw_message, &pos]() -> std::string_view {
+    const std::string_view::size_type pos_end{
+        std::min(raw_message.find(k_delimiter_space, pos), raw_message.size())};
+    const std::string_view word{raw_message.substr(pos, (pos_end - pos))};
+    pos = pos_end;
+    return word;
+  }};
+
+  if ((pos < raw_message.size()) &&
+      (raw_message[pos] == k_delimiter_at_sign)) {
+    ++pos;
+    tokens.tags = next_word();
+    skip_spaces();
+  }
+
+  if ((pos < raw_message.size()) && (raw_message[pos] == k_delimiter_colon)) {
+    ++pos;
+    tokens.prefix = next_word();
+    skip_spaces();
+  }
+
+  tokens.command = next_word();
+
+  while (tokens.param_count < message_tokens::k_max_params) {
+    skip_spaces();
+
+    if (pos >= raw_message.size()) {
+      break;
+    }
+
+    if (raw_message[pos] == k_delimiter_colon) {
+      tokens.params[tokens.param_count++] = raw_message.substr(pos + 1);
+      tokens.has_trailing = true;
+      break;
+    } else if (tokens.param_count == (message_tokens::k_max_params - 1)) {
+      tokens.params[tokens.param_count++] = raw_message.substr(pos);
+      tokens.has_trailing = true;
+      break;
+    } else {
+      tokens.params[tokens.param_count++] = next_word();
+    }
+  }
+
+  return tokens;
+}
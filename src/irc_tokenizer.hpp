@@ -0,0 +1,33 @@
+#ifndef VASSAL_IRC_TOKENIZER_HPP
+#define VASSAL_IRC_TOKENIZER_HPP
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+namespace vassal {
+
+namespace irc {
+// Result of a single left-to-right pass over one line:
+// ['@' tags SPACE] [':' prefix SPACE] command *14(SPACE middle)
+// [SPACE [':'] trailing]
+struct message_tokens {
+  static constexpr std::size_t k_max_params{15};
+
+  std::string_view tags;
+  std::string_view prefix;
+  std::string_view command;
+  std::array<std::string_view, k_max_params> params;
+  std::size_t param_count;
+  bool has_trailing;
+
+  std::span<const std::string_view> get_params() const;
+  bool is_numeric() const;
+};
+
+message_tokens tokenize(const std::string_view raw_message);
+} // namespace irc
+
+} // namespace vassal
+#endif